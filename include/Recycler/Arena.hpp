@@ -0,0 +1,291 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_ARENA_HPP__
+#define __RECYCLER_ARENA_HPP__
+
+#include <Recycler/Buffer.hpp>
+#include <Recycler/Circular.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace recycler {
+
+/**
+ * @brief      Bump allocator for short lived objects that all die at the same time,
+ * typically at the end of a frame or of a request.
+ * Memory is carved from `Buffer<std::uint8_t>` chunks taken from a `Circular` pool.
+ * Objects are constructed in place, there is no `std::shared_ptr` and no per object bookkeeping.
+ * Only objects that aren't trivially destructible register a destructor, that is run by `reset()`.
+ *
+ * `reset()` destroy those objects in reverse order of construction, rewind to the start of the
+ * first chunk, and give every other chunk back to the pool. Once a frame fit in one chunk,
+ * resetting trivially destructible objects is O(1) and doesn't touch the pool.
+ * `release()` also give the first chunk back.
+ * Requests bigger than a chunk get a dedicated chunk from the pool.
+ * The arena isn't thread safe.
+ *
+ * @tparam     Pool  Circular pool of `Buffer<std::uint8_t>` that provide chunks
+ */
+template<class Pool = Circular<Buffer<std::uint8_t>>>
+class Arena
+{
+    // ──────── TYPE ────────────
+public:
+    typedef std::shared_ptr<Buffer<std::uint8_t>> SharedBuffer;
+
+protected:
+    /** @brief Destroy `count` objects starting at `object`, stored in the arena itself */
+    struct Finalizer
+    {
+        void (*destroy)(void* object, std::size_t count);
+        void* object;
+        std::size_t count;
+        Finalizer* next;
+    };
+
+    // ──────── CONSTRUCTOR ────────────
+public:
+    /**
+     * @param pool          Pool that provide chunks. It must outlive the arena.
+     * @param chunkSize     Size in bytes of chunks taken from `pool`
+     */
+    Arena(Pool& pool, std::size_t chunkSize = 64 * 1024) :
+        _pool(&pool), _chunkSize(std::max(chunkSize, sizeof(Finalizer)))
+    {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() { release(); }
+
+    // ──────── ATTRIBUTES ────────────
+protected:
+    /** @brief Pool where chunks are taken from */
+    Pool* _pool;
+    /** @brief Size of chunks taken from `_pool` */
+    std::size_t _chunkSize;
+    /** @brief First chunk, kept by `reset()` and reused by next frame */
+    SharedBuffer _first;
+    /** @brief Extra and dedicated chunks, kept alive until `reset()` */
+    std::vector<SharedBuffer> _chunks;
+    /** @brief Bump pointer in the current chunk */
+    std::uint8_t* _cursor = nullptr;
+    std::uint8_t* _end = nullptr;
+    /** @brief Last registered destructor, list is walked from newest to oldest */
+    Finalizer* _finalizers = nullptr;
+    /** @brief Bytes handed out since last `reset()`, padding included */
+    std::size_t _used = 0;
+
+    // ──────── API ────────────
+public:
+    std::size_t chunkSize() const { return _chunkSize; }
+
+    /**
+     * @brief      Number of chunks taken from the pool
+     */
+    std::size_t chunkCount() const
+    {
+        return _chunks.size() + (_first ? 1 : 0);
+    }
+
+    /**
+     * @brief      Bytes handed out since last `reset()`, alignment padding and destructor records included
+     */
+    std::size_t used() const { return _used; }
+
+    /**
+     * @brief      Uninitialized memory that stay valid until `reset()`
+     *
+     * @param bytes         Size of the memory
+     * @param alignment     Power of two alignment of the memory
+     */
+    void* allocate(
+        std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        if(!bytes)
+            bytes = 1;
+
+        const auto offset =
+            reinterpret_cast<std::uintptr_t>(_cursor) % alignment;
+        const std::size_t padding = offset ? alignment - offset : 0;
+        if(_cursor && std::size_t(_end - _cursor) >= padding + bytes)
+        {
+            auto* p = _cursor + padding;
+            _cursor = p + bytes;
+            _used += padding + bytes;
+            return p;
+        }
+
+        // Worst case padding of a fresh chunk
+        const auto required = bytes + alignment - 1;
+        if(required > _chunkSize)
+        {
+            // Dedicated chunk, the current one keep serving small requests
+            auto* chunk = acquire(required);
+            auto* p = align(chunk, alignment);
+            _used += bytes;
+            return p;
+        }
+
+        if(_first)
+            _cursor = acquire(_chunkSize);
+        else
+        {
+            _first = _pool->make(_chunkSize, false);
+            _cursor = _first->buffer();
+        }
+        _end = _cursor + _chunkSize;
+        auto* p = align(_cursor, alignment);
+        _cursor = p + bytes;
+        _used += bytes;
+        return p;
+    }
+
+    /**
+     * @brief      Construct an object in the arena.
+     * Its destructor is called by `reset()` unless it is trivially destructible.
+     */
+    template<class T, typename... Types>
+    T* make(Types&&... args)
+    {
+        Finalizer* finalizer = nullptr;
+        if(!std::is_trivially_destructible<T>::value)
+            finalizer = static_cast<Finalizer*>(
+                allocate(sizeof(Finalizer), alignof(Finalizer)));
+
+        auto* object = new(allocate(sizeof(T), alignof(T)))
+            T(std::forward<Types>(args)...);
+
+        if(finalizer)
+            registerFinalizer(finalizer, &destroy<T>, object, 1);
+        return object;
+    }
+
+    /**
+     * @brief      Construct `count` value initialized objects in the arena.
+     * Their destructors are called by `reset()` unless they are trivially destructible.
+     */
+    template<class T>
+    T* makeArray(std::size_t count)
+    {
+        Finalizer* finalizer = nullptr;
+        if(!std::is_trivially_destructible<T>::value)
+            finalizer = static_cast<Finalizer*>(
+                allocate(sizeof(Finalizer), alignof(Finalizer)));
+
+        auto* objects =
+            static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        std::size_t constructed = 0;
+        try
+        {
+            for(; constructed < count; ++constructed)
+                new(objects + constructed) T();
+        }
+        catch(...)
+        {
+            destroy<T>(objects, constructed);
+            throw;
+        }
+
+        if(finalizer)
+            registerFinalizer(finalizer, &destroy<T>, objects, count);
+        return objects;
+    }
+
+    /**
+     * @brief      Destroy every object that isn't trivially destructible, newest first,
+     * rewind to the start of the first chunk and give every other chunk back to the pool.
+     * All memory handed out by the arena becomes invalid.
+     */
+    void reset()
+    {
+        for(auto* finalizer = _finalizers; finalizer;
+            finalizer = finalizer->next)
+            finalizer->destroy(finalizer->object, finalizer->count);
+        _finalizers = nullptr;
+
+        if(!_chunks.empty())
+            _chunks.clear();
+        _cursor = _first ? _first->buffer() : nullptr;
+        _end = _first ? _cursor + _chunkSize : nullptr;
+        _used = 0;
+    }
+
+    /**
+     * @brief      `reset()` then also give the first chunk back to the pool
+     */
+    void release()
+    {
+        reset();
+        _first = nullptr;
+        _cursor = nullptr;
+        _end = nullptr;
+    }
+
+protected:
+    /**
+     * @brief      Take a chunk from the pool, its memory is kept until `reset()`
+     */
+    std::uint8_t* acquire(std::size_t size)
+    {
+        _chunks.push_back(_pool->make(size, false));
+        return _chunks.back()->buffer();
+    }
+
+    static std::uint8_t* align(std::uint8_t* p, std::size_t alignment)
+    {
+        const auto offset = reinterpret_cast<std::uintptr_t>(p) % alignment;
+        return offset ? p + alignment - offset : p;
+    }
+
+    void registerFinalizer(Finalizer* finalizer,
+        void (*destroy)(void*, std::size_t), void* object, std::size_t count)
+    {
+        finalizer->destroy = destroy;
+        finalizer->object = object;
+        finalizer->count = count;
+        finalizer->next = _finalizers;
+        _finalizers = finalizer;
+    }
+
+    template<class T>
+    static void destroy(void* object, std::size_t count)
+    {
+        auto* objects = static_cast<T*>(object);
+        while(count) objects[--count].~T();
+    }
+};
+
+}
+
+#endif
@@ -25,13 +25,26 @@
 #ifndef __RECYCLER_BUFFER_HPP__
 #define __RECYCLER_BUFFER_HPP__
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <cstring>
+#include <initializer_list>
 
 namespace recycler {
 
+/**
+ * @brief      Resizable array that only reallocate when growing, made to be recycled by `Circular`.
+ * The buffer tracks the range of elements that may have been written since it was last cleared,
+ * so `reset(length, true)` only clear this range instead of the whole `length()`.
+ * Non const raw access (`buffer()`, auto cast, iterators) conservatively mark the whole `length()` as written,
+ * `operator[]` only mark the accessed element. Caller writing through a raw pointer can then declare
+ * what was really written with `markWritten()`, that replaces the raw access mark but keeps elements
+ * marked by `operator[]`.
+ *
+ * @tparam     T     Type of elements
+ */
 template<typename T>
 class Buffer
 {
@@ -40,6 +53,11 @@ private:
     std::unique_ptr<T[]> _buffer;
     std::size_t _length = 0;
     std::size_t _maxSize = 0;
+    /** @brief Range of elements written by `operator[]` or declared by `markWritten()`. Empty when `_dirtyBegin == _dirtyEnd` */
+    std::size_t _dirtyBegin = 0;
+    std::size_t _dirtyEnd = 0;
+    /** @brief Elements in [0, `_rawDirtyEnd`) may have been written through raw access */
+    std::size_t _rawDirtyEnd = 0;
 
     // ──────── CONSTRUCTOR ────────────
 public:
@@ -53,9 +71,20 @@ public:
     bool reset(std::size_t length, bool clearBuffer = true)
     {
         resize(length);
-        if(clearBuffer)
+        const auto begin = dirtyBegin();
+        if(clearBuffer && begin < _length)
         {
-            for(std::size_t i = 0; i < _length; ++i) { _buffer[i] = {}; }
+            // Only clear what was written since last clear
+            const auto dirtyLast = dirtyEnd();
+            const auto end = std::min(dirtyLast, _length);
+            for(std::size_t i = begin; i < end; ++i) { _buffer[i] = {}; }
+
+            // Elements written after `_length` are still dirty
+            _rawDirtyEnd = 0;
+            _dirtyBegin = end;
+            _dirtyEnd = dirtyLast;
+            if(_dirtyBegin == _dirtyEnd)
+                _dirtyBegin = _dirtyEnd = 0;
         }
         return true;
     }
@@ -69,12 +98,17 @@ public:
         // Then copy initializer_list to out buffer
         auto it = l.begin();
         for(std::size_t i = 0; i < _length; ++i) { _buffer[i] = *it++; }
+        markDirty(0, _length);
         return true;
     }
 
     // ──────── API ────────────
 public:
-    T* buffer() { return _buffer.get(); }
+    T* buffer()
+    {
+        _rawDirtyEnd = std::max(_rawDirtyEnd, _length);
+        return _buffer.get();
+    }
 
     const T* buffer() const { return _buffer.get(); }
 
@@ -86,6 +120,29 @@ public:
 
     std::size_t maxSize() const { return _maxSize; }
 
+    /**
+     * @brief      Declare that only `length` elements starting at `offset` were written through raw access
+     * since last `reset()`. This replaces the whole `length()` mark set by raw access, elements marked by
+     * `operator[]` stay dirty. Next `reset(length, true)` only clear those elements.
+     * Typically called after writing through `buffer()`, for example with `recv` or `memcpy`.
+     */
+    void markWritten(std::size_t length, std::size_t offset = 0)
+    {
+        _rawDirtyEnd = 0;
+        markDirty(
+            std::min(offset, _maxSize), std::min(offset + length, _maxSize));
+    }
+
+    /**
+     * @brief      First element that may have been written since last clear
+     */
+    std::size_t dirtyBegin() const { return _rawDirtyEnd ? 0 : _dirtyBegin; }
+
+    /**
+     * @brief      Element after the last one that may have been written since last clear
+     */
+    std::size_t dirtyEnd() const { return std::max(_rawDirtyEnd, _dirtyEnd); }
+
     void release()
     {
         if(_length != _maxSize)
@@ -94,6 +151,7 @@ public:
             {
                 _buffer = std::make_unique<T[]>(_length);
                 _maxSize = _length;
+                _dirtyBegin = _dirtyEnd = _rawDirtyEnd = 0;
             }
             else
                 reset(0);
@@ -107,14 +165,17 @@ public:
             _length = 0;
             _maxSize = 0;
             _buffer = nullptr;
+            _dirtyBegin = _dirtyEnd = _rawDirtyEnd = 0;
             return true;
         }
 
         if(!_buffer || _maxSize < length)
         {
+            // New memory is value initialized, nothing is dirty
             _buffer = std::make_unique<T[]>(length);
             _length = length;
             _maxSize = length;
+            _dirtyBegin = _dirtyEnd = _rawDirtyEnd = 0;
         }
         else if(length != _length)
         {
@@ -128,14 +189,18 @@ public:
 
     // ──────── ACCESSOR ────────────
 public:
-    T& operator[](const std::size_t offset) { return _buffer[offset]; }
+    T& operator[](const std::size_t offset)
+    {
+        markDirty(offset, offset + 1);
+        return _buffer[offset];
+    }
 
     const T& operator[](const std::size_t offset) const
     {
         return _buffer[offset];
     }
 
-    operator T*() { return _buffer.get(); }
+    operator T*() { return buffer(); }
     operator const T*() const { return _buffer.get(); }
 
     // ──────── ITERATOR ────────────
@@ -331,13 +396,30 @@ public:
         const T* operator->() { return _ptr; }
     };
 
-    iterator begin() { return iterator(&_buffer.get()[0]); }
-    iterator end() { return iterator(&_buffer.get()[_length]); }
+    iterator begin() { return iterator(&buffer()[0]); }
+    iterator end() { return iterator(&buffer()[_length]); }
     const_iterator cbegin() const { return const_iterator(&_buffer.get()[0]); }
     const_iterator cend() const
     {
         return const_iterator(&_buffer.get()[_length]);
     }
+
+private:
+    void markDirty(std::size_t begin, std::size_t end)
+    {
+        if(begin >= end)
+            return;
+        if(_dirtyBegin == _dirtyEnd)
+        {
+            _dirtyBegin = begin;
+            _dirtyEnd = end;
+        }
+        else
+        {
+            _dirtyBegin = std::min(_dirtyBegin, begin);
+            _dirtyEnd = std::max(_dirtyEnd, end);
+        }
+    }
 };
 
 }
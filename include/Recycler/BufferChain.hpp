@@ -0,0 +1,391 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_BUFFER_CHAIN_HPP__
+#define __RECYCLER_BUFFER_CHAIN_HPP__
+
+#include <Recycler/Buffer.hpp>
+#include <Recycler/Circular.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#if !defined(_WIN32)
+#    include <sys/uio.h>
+#endif
+
+namespace recycler {
+
+#if defined(_WIN32)
+/**
+ * @brief Mirror of POSIX `struct iovec` so the chain can be described the same way on every platform
+ */
+struct iovec
+{
+    void* iov_base;
+    std::size_t iov_len;
+};
+#else
+using ::iovec;
+#endif
+
+/**
+ * @brief      Chain of recycled byte segments that can be exposed as an `iovec` array.
+ * Segments are fixed size `Buffer<std::uint8_t>` taken from a `Circular` pool.
+ * Already filled buffers (a payload for example) can be linked at the front or at the back
+ * of the chain without any copy. This let `writev` send header and payload in one call,
+ * and `readv` fill pooled segments directly.
+ * Once consumed, a segment is dropped by the chain and goes back to its pool.
+ *
+ * @tparam     Pool  Circular pool of `Buffer<std::uint8_t>` that provide segments
+ */
+template<class Pool = Circular<Buffer<std::uint8_t>>>
+class BufferChain
+{
+    // ──────── TYPE ────────────
+public:
+    typedef std::shared_ptr<Buffer<std::uint8_t>> SharedBuffer;
+
+protected:
+    struct Segment
+    {
+        SharedBuffer buffer;
+        /** @brief Offset of the first readable byte */
+        std::size_t begin;
+        /** @brief Offset after the last readable byte */
+        std::size_t end;
+        /** @brief True if segment come from the pool and its free space can be written by the chain */
+        bool writable;
+    };
+
+    // ──────── CONSTRUCTOR ────────────
+public:
+    /**
+     * @brief Create an empty chain. No segment is taken from the pool until data is written.
+     *
+     * @param pool          Pool that provide segments. It must outlive the chain.
+     * @param segmentSize   Size in bytes of segments taken from the pool
+     */
+    BufferChain(Pool& pool, std::size_t segmentSize = 4096) :
+        _pool(&pool), _segmentSize(segmentSize ? segmentSize : 1)
+    {
+    }
+
+    // Copies would share writable pool segments at head and tail
+    BufferChain(const BufferChain&) = delete;
+    BufferChain& operator=(const BufferChain&) = delete;
+
+    BufferChain(BufferChain&&) = default;
+    BufferChain& operator=(BufferChain&&) = default;
+
+    // ──────── ATTRIBUTES ────────────
+protected:
+    /** @brief Pool where segments are taken from */
+    Pool* _pool;
+    /** @brief Size of segments taken from `_pool` */
+    std::size_t _segmentSize;
+    /** @brief Segments holding readable data, in order */
+    std::deque<Segment> _segments;
+    /** @brief Segments taken by `prepare()` that are not yet committed */
+    std::deque<SharedBuffer> _spares;
+    /** @brief Number of readable bytes in `_segments` */
+    std::size_t _length = 0;
+
+    // ──────── API ────────────
+public:
+    /**
+     * @brief      Number of readable bytes in the chain
+     */
+    std::size_t length() const { return _length; }
+
+    std::size_t size() const { return length(); }
+
+    bool empty() const { return _length == 0; }
+
+    /**
+     * @brief      Number of segments holding readable data.
+     * This is the number of `iovec` required to describe the whole chain.
+     */
+    std::size_t segmentCount() const { return _segments.size(); }
+
+    std::size_t segmentSize() const { return _segmentSize; }
+
+    /**
+     * @brief      Link `length` first bytes of `buffer` at the end of the chain. No copy happen.
+     * The chain keeps a reference on `buffer` until those bytes are consumed.
+     */
+    void append(SharedBuffer buffer, std::size_t length)
+    {
+        if(!buffer || !length)
+            return;
+        length = std::min(length, buffer->length());
+        _segments.push_back(Segment {std::move(buffer), 0, length, false});
+        _length += length;
+    }
+
+    void append(SharedBuffer buffer)
+    {
+        const auto length = buffer ? buffer->length() : 0;
+        append(std::move(buffer), length);
+    }
+
+    /**
+     * @brief      Link `length` first bytes of `buffer` at the front of the chain. No copy happen.
+     */
+    void prepend(SharedBuffer buffer, std::size_t length)
+    {
+        if(!buffer || !length)
+            return;
+        length = std::min(length, buffer->length());
+        _segments.push_front(Segment {std::move(buffer), 0, length, false});
+        _length += length;
+    }
+
+    void prepend(SharedBuffer buffer)
+    {
+        const auto length = buffer ? buffer->length() : 0;
+        prepend(std::move(buffer), length);
+    }
+
+    /**
+     * @brief      Copy `length` bytes at the end of the chain.
+     * Free space of the last segment is used first, then segments are taken from the pool.
+     * This is meant for small data like headers, big payload should be linked with `append(SharedBuffer)`.
+     */
+    void append(const void* data, std::size_t length)
+    {
+        const auto* src = static_cast<const std::uint8_t*>(data);
+        while(length)
+        {
+            if(tailSpace() == 0)
+                _segments.push_back(Segment {acquire(), 0, 0, true});
+
+            auto& back = _segments.back();
+            const auto count = std::min(length, back.buffer->length() - back.end);
+            std::memcpy(back.buffer->buffer() + back.end, src, count);
+            back.end += count;
+            _length += count;
+            src += count;
+            length -= count;
+        }
+    }
+
+    /**
+     * @brief      Copy `length` bytes at the front of the chain.
+     * Data is written at the end of new segments, so following prepend can reuse the space left in front of it.
+     */
+    void prepend(const void* data, std::size_t length)
+    {
+        const auto* src = static_cast<const std::uint8_t*>(data);
+        while(length)
+        {
+            if(headSpace() == 0)
+            {
+                auto buffer = acquire();
+                const auto end = buffer->length();
+                _segments.push_front(Segment {std::move(buffer), end, end, true});
+            }
+
+            auto& front = _segments.front();
+            const auto count = std::min(length, front.begin);
+            front.begin -= count;
+            std::memcpy(
+                front.buffer->buffer() + front.begin, src + length - count, count);
+            _length += count;
+            length -= count;
+        }
+    }
+
+    /**
+     * @brief      Fill `iov` with the readable regions of the chain, ready for `writev`.
+     *
+     * @param      iov     Output array
+     * @param[in]  maxIov  Size of `iov`
+     *
+     * @return     Number of `iovec` written in `iov`
+     */
+    std::size_t iovecs(iovec* iov, std::size_t maxIov) const
+    {
+        std::size_t count = 0;
+        for(auto it = _segments.begin(); it != _segments.end() && count < maxIov;
+            ++it)
+        {
+            if(it->begin == it->end)
+                continue;
+            iov[count].iov_base = it->buffer->buffer() + it->begin;
+            iov[count].iov_len = it->end - it->begin;
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief      Make sure at least `length` bytes can be written at the end of the chain,
+     * and fill `iov` with the writable regions, ready for `readv`.
+     * Written bytes only become readable after `commit()`.
+     *
+     * @param[in]  length  Number of bytes that will be written
+     * @param      iov     Output array
+     * @param[in]  maxIov  Size of `iov`
+     *
+     * @return     Number of `iovec` written in `iov`
+     */
+    std::size_t prepare(std::size_t length, iovec* iov, std::size_t maxIov)
+    {
+        std::size_t count = 0;
+        std::size_t available = 0;
+
+        if(const auto space = tailSpace())
+        {
+            if(count < maxIov)
+            {
+                auto& back = _segments.back();
+                iov[count].iov_base = back.buffer->buffer() + back.end;
+                iov[count].iov_len = space;
+                ++count;
+            }
+            available += space;
+        }
+
+        for(std::size_t i = 0; available < length; ++i)
+        {
+            if(i == _spares.size())
+                _spares.push_back(acquire());
+
+            const auto& spare = _spares[i];
+            if(count < maxIov)
+            {
+                iov[count].iov_base = spare->buffer();
+                iov[count].iov_len = spare->length();
+                ++count;
+            }
+            available += spare->length();
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief      Make `length` bytes written in regions returned by `prepare()` readable.
+     */
+    void commit(std::size_t length)
+    {
+        if(const auto space = tailSpace())
+        {
+            const auto count = std::min(length, space);
+            _segments.back().end += count;
+            _length += count;
+            length -= count;
+        }
+
+        while(length && !_spares.empty())
+        {
+            auto buffer = std::move(_spares.front());
+            _spares.pop_front();
+            const auto count = std::min(length, buffer->length());
+            _segments.push_back(Segment {std::move(buffer), 0, count, true});
+            _length += count;
+            length -= count;
+        }
+    }
+
+    /**
+     * @brief      Remove `length` bytes from the front of the chain, typically after a `writev`.
+     * Fully consumed segments are released and go back to their pool.
+     */
+    void consume(std::size_t length)
+    {
+        length = std::min(length, _length);
+        _length -= length;
+        while(length)
+        {
+            auto& front = _segments.front();
+            const auto count = std::min(length, front.end - front.begin);
+            front.begin += count;
+            length -= count;
+            if(front.begin == front.end)
+                _segments.pop_front();
+        }
+        while(!_segments.empty() && _segments.front().begin == _segments.front().end)
+            _segments.pop_front();
+    }
+
+    /**
+     * @brief      Copy up to `length` bytes from the front of the chain into `data` then consume them
+     *
+     * @return     Number of bytes copied
+     */
+    std::size_t read(void* data, std::size_t length)
+    {
+        auto* dst = static_cast<std::uint8_t*>(data);
+        length = std::min(length, _length);
+        std::size_t copied = 0;
+        for(auto it = _segments.begin(); copied < length; ++it)
+        {
+            const auto count = std::min(length - copied, it->end - it->begin);
+            std::memcpy(dst + copied, it->buffer->buffer() + it->begin, count);
+            copied += count;
+        }
+        consume(copied);
+        return copied;
+    }
+
+    /**
+     * @brief      Release every segment. They go back to their pool.
+     */
+    void clear()
+    {
+        _segments.clear();
+        _spares.clear();
+        _length = 0;
+    }
+
+protected:
+    SharedBuffer acquire() { return _pool->make(_segmentSize, false); }
+
+    /** @brief Free bytes at the end of last segment that the chain is allowed to write */
+    std::size_t tailSpace() const
+    {
+        if(_segments.empty() || !_segments.back().writable)
+            return 0;
+        const auto& back = _segments.back();
+        return back.buffer->length() - back.end;
+    }
+
+    /** @brief Free bytes in front of the first segment that the chain is allowed to write */
+    std::size_t headSpace() const
+    {
+        if(_segments.empty() || !_segments.front().writable)
+            return 0;
+        return _segments.front().begin;
+    }
+};
+
+}
+
+#endif
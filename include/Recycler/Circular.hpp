@@ -25,9 +25,16 @@
 #ifndef __RECYCLER_CIRCULAR_HPP__
 #define __RECYCLER_CIRCULAR_HPP__
 
+#include <Recycler/Eviction.hpp>
+#include <Recycler/ResetTraits.hpp>
+
 #include <cstdint>
 #include <memory>
 
+#if defined(RECYCLER_ENABLE_TRACING)
+#    include <Recycler/Tracer.hpp>
+#endif
+
 namespace recycler {
 
 /**
@@ -36,10 +43,18 @@ namespace recycler {
  * It's circular because once MAX object created, the object try to reallocate first object
  * If an object is still in use it just get removed from the cache and replaced by the newly allocated one.
  *
- * @tparam     T     Class of the object in the cache
- * @tparam     MAX   Size of the circular buffer
+ * When `RECYCLER_ENABLE_TRACING` is defined, lifetime of every object handed out is recorded in `tracer()`.
+ * Returned `std::shared_ptr` then only count user references, the one of the cache isn't included.
+ *
+ * Recycled objects are reset through `ResetTraits<T>`: either `T::reset(args...)` is called,
+ * or `T::clear()` for standard containers.
+ *
+ * @tparam     T         Class of the object in the cache
+ * @tparam     MAX       Size of the circular buffer
+ * @tparam     Eviction  Policy choosing the slot to use when the cache is full and no object
+ * could be recycled right away. See `RingEviction`, `ClockEviction` and `LruEviction`.
  */
-template<class T, std::size_t MAX = 16>
+template<class T, std::size_t MAX = 16, class Eviction = RingEviction>
 class Circular
 {
     // ──────── TYPE ────────────
@@ -51,7 +66,10 @@ public:
     /**
      * @brief Allocate `_cache` to size MAX. It can be resized later with `resize()`
      */
-    Circular() : _cache(std::make_unique<SharedObject[]>(MAX)) {}
+    Circular() : _cache(std::make_unique<SharedObject[]>(MAX))
+    {
+        _eviction.resize(MAX);
+    }
 
     // ──────── ATTRIBUTES ────────────
 protected:
@@ -63,6 +81,12 @@ protected:
     std::size_t _size = 0;
     /** @brief Size of `_cache` */
     std::size_t _maxSize = MAX;
+    /** @brief Choose the slot to use once `_cache` is full */
+    Eviction _eviction;
+#if defined(RECYCLER_ENABLE_TRACING)
+    /** @brief Record lifetime of objects returned by `make()`. Shared with handed out objects so it outlive them */
+    std::shared_ptr<Tracer> _tracer = std::make_shared<Tracer>();
+#endif
 
     // ──────── API ────────────
 public:
@@ -91,8 +115,9 @@ public:
             if(first && first.use_count() == 1)
             {
                 _idx = 0;
-                first->reset(std::forward<Types>(args)...);
-                return first;
+                ResetTraits<T>::reset(*first, std::forward<Types>(args)...);
+                _eviction.recycled(0);
+                return trace(first);
             }
 
             // Try to recycle next object
@@ -102,30 +127,153 @@ public:
                 if(next && next.use_count() == 1)
                 {
                     ++_idx;
-                    next->reset(std::forward<Types>(args)...);
-                    return next;
+                    ResetTraits<T>::reset(*next, std::forward<Types>(args)...);
+                    _eviction.recycled(_idx);
+                    return trace(next);
                 }
             }
+
+            // Cache is full, eviction policy choose the slot to recycle or replace
+            if(_size == _maxSize)
+            {
+                _idx = _eviction.select(
+                    static_cast<const SharedObject*>(_cache.get()), _size, _idx);
+
+                const auto& item = _cache[_idx];
+                if(item && item.use_count() == 1)
+                {
+                    ResetTraits<T>::reset(*item, std::forward<Types>(args)...);
+                    _eviction.recycled(_idx);
+                    return trace(item);
+                }
+
+                return insert(
+                    std::make_shared<T>(std::forward<Types>(args)...));
+            }
         }
 
-        // Create new object that will either make the cache grow if (_size != _maxSize) or replace
-        // a previously allocated item in the cache
+        // Create new object that make the cache grow
         const auto object = std::make_shared<T>(std::forward<Types>(args)...);
 
-        // Cache is growing
-        if(_size != _maxSize)
-            ++_size;
-
+        ++_size;
         ++_idx;
 
         // Handle circular loop
         if(_idx >= _size)
             _idx = 0;
 
+        return insert(object);
+    }
+
+    /**
+     * @brief      Get `count` objects at once, for burst processing.
+     * Free objects are claimed in a single pass over the cache and reset in the same loop,
+     * instead of restarting the first/next lookup of `make()` for each object.
+     * Missing objects are then allocated like `make()` would.
+     *
+     * @param[in]  count  Number of objects to get
+     * @param[in]  out    Output iterator receiving the shared objects
+     * @param[in]  args   The arguments of constructor/reset function
+     *
+     * @tparam     OutputIt  Output iterator of shared objects
+     * @tparam     Types     Arguments of constructor/reset function
+     *
+     * @return     Output iterator past the last object written
+     */
+    template<class OutputIt, typename... Types>
+    OutputIt makeN(std::size_t count, OutputIt out, Types... args)
+    {
+        std::size_t made = 0;
+
+        // Claim free objects. Once written to `out` they are in use and won't be claimed again
+        for(std::size_t slot = 0; slot < _size && made < count; ++slot)
+        {
+            const auto& item = _cache[slot];
+            if(item && item.use_count() == 1)
+            {
+                ResetTraits<T>::reset(*item, args...);
+                _eviction.recycled(slot);
+                *out = trace(item);
+                ++out;
+                _idx = slot;
+                ++made;
+            }
+        }
+
+        for(; made < count; ++made)
+        {
+            *out = make(args...);
+            ++out;
+        }
+
+        return out;
+    }
+
+    /**
+     * @brief      Give back `count` objects at once, for example the one returned by `makeN()`.
+     * Each shared object is reset, so objects only referenced by the cache can be recycled right away.
+     *
+     * @param[in]  first  Iterator on the first shared object to give back
+     * @param[in]  count  Number of shared objects to give back
+     *
+     * @tparam     ForwardIt  Forward iterator of shared objects
+     *
+     * @return     Iterator past the last object given back
+     */
+    template<class ForwardIt>
+    ForwardIt releaseN(ForwardIt first, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; ++i, ++first) *first = nullptr;
+        return first;
+    }
+
+#if defined(RECYCLER_ENABLE_TRACING)
+    /**
+     * @brief      Lifetime recorder of this cache
+     */
+    const std::shared_ptr<Tracer>& tracer() const { return _tracer; }
+#endif
+
+protected:
+    /**
+     * @brief      Store a newly allocated `object` at `_idx`.
+     * Previous item at `_idx` is removed from the cache.
+     */
+    SharedObject insert(const SharedObject& object)
+    {
+#if defined(RECYCLER_ENABLE_TRACING)
+        // Replaced item is still in use, it won't be recycled anymore
+        if(_cache[_idx] && _cache[_idx].use_count() > 1)
+            _tracer->evict(_cache[_idx].get());
+#endif
+
         // Create or override item at idx
         _cache[_idx] = object;
+        _eviction.inserted(_idx);
 
+        return trace(object);
+    }
+
+    /**
+     * @brief      Wrap `object` into a new `std::shared_ptr` that report to `_tracer` when its last copy is dropped.
+     * The deleter keeps a reference on `object`, so it stays in use for the cache until then.
+     * Without `RECYCLER_ENABLE_TRACING`, `object` is returned as is.
+     */
+    SharedObject trace(const SharedObject& object)
+    {
+#if defined(RECYCLER_ENABLE_TRACING)
+        const auto id = _tracer->acquire(object.get(), TraceSite::current());
+        auto tracer = _tracer;
+        auto owner = object;
+        return SharedObject(object.get(),
+            [tracer, owner, id](T*) mutable
+            {
+                tracer->release(id);
+                owner = nullptr;
+            });
+#else
         return object;
+#endif
     }
 
 public:
@@ -160,6 +308,8 @@ public:
         _cache = std::make_unique<SharedObject[]>(maxSize);
         _idx = 0;
         _size = 0;
+        _maxSize = maxSize;
+        _eviction.resize(maxSize);
         return true;
     }
 
@@ -173,7 +323,7 @@ public:
         std::size_t size = 0;
 
         // Keep in cache all reusable items
-        for(auto i = 0; i < _maxSize; ++i)
+        for(std::size_t i = 0; i < _maxSize; ++i)
             if(_cache[i] && _cache[i].use_count() == 1)
                 cache[size++] = _cache[i];
 
@@ -194,6 +344,7 @@ public:
         for(std::size_t i = 0; i < _maxSize; ++i) _cache[i] = nullptr;
         _idx = 0;
         _size = 0;
+        _eviction.resize(_maxSize);
     }
 };
 
@@ -0,0 +1,169 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_EVICTION_HPP__
+#define __RECYCLER_EVICTION_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace recycler {
+
+// Eviction policies decide which slot `Circular::make()` uses once the cache is full
+// and neither the first nor the next slot can be recycled.
+// A policy provides:
+// - `void resize(std::size_t maxSize)`: forget all state, cache now has `maxSize` empty slots.
+// - `void recycled(std::size_t slot)`: object in `slot` has been handed out again.
+// - `void inserted(std::size_t slot)`: a newly allocated object has been stored in `slot`.
+// - `std::size_t select(const SharedObject* cache, std::size_t size, std::size_t idx)`:
+//   return the slot to use. If the object in this slot isn't in use it is recycled,
+//   otherwise it is evicted from the cache and replaced by a newly allocated object.
+
+/**
+ * @brief      Default policy, always use the slot after the last one handed out.
+ * This is the historical behavior of `Circular`, no state is kept.
+ */
+class RingEviction
+{
+public:
+    void resize(std::size_t) {}
+    void recycled(std::size_t) {}
+    void inserted(std::size_t) {}
+
+    template<class SharedObject>
+    std::size_t select(const SharedObject*, std::size_t size, std::size_t idx)
+    {
+        return idx + 1 < size ? idx + 1 : 0;
+    }
+};
+
+/**
+ * @brief      CLOCK (second chance) policy.
+ * Each slot has a small counter incremented every time its object is recycled.
+ * A free slot anywhere in the cache is recycled first. Otherwise a hand sweeps the cache:
+ * a busy slot with a non zero counter get its counter decremented and is skipped,
+ * a busy slot with a zero counter is evicted. Objects that are reused often survive longer than
+ * objects that are held once for a long time.
+ */
+class ClockEviction
+{
+    // ──────── CONSTANTS ────────────
+public:
+    /** @brief Maximum value of a slot counter, it bounds the length of a sweep */
+    static constexpr std::uint8_t MAX_WEIGHT = 3;
+
+    // ──────── ATTRIBUTES ────────────
+protected:
+    std::unique_ptr<std::uint8_t[]> _weights;
+    std::size_t _hand = 0;
+
+    // ──────── API ────────────
+public:
+    void resize(std::size_t maxSize)
+    {
+        _weights = std::make_unique<std::uint8_t[]>(maxSize);
+        _hand = 0;
+    }
+
+    void recycled(std::size_t slot)
+    {
+        if(_weights[slot] < MAX_WEIGHT)
+            ++_weights[slot];
+    }
+
+    void inserted(std::size_t slot) { _weights[slot] = 0; }
+
+    template<class SharedObject>
+    std::size_t select(const SharedObject* cache, std::size_t size, std::size_t)
+    {
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            const auto slot = (_hand + i) % size;
+            if(!cache[slot] || cache[slot].use_count() == 1)
+            {
+                _hand = slot + 1;
+                return slot;
+            }
+        }
+
+        // Every busy slot lose one chance per turn, so at most MAX_WEIGHT + 1 turns are required
+        const std::size_t steps = size * (MAX_WEIGHT + 1);
+        for(std::size_t i = 0; i < steps; ++i)
+        {
+            const auto slot = _hand < size ? _hand : 0;
+            _hand = slot + 1;
+
+            if(!_weights[slot])
+                return slot;
+            --_weights[slot];
+        }
+        return _hand < size ? _hand : 0;
+    }
+};
+
+/**
+ * @brief      Least recently released policy.
+ * Each slot is stamped with a logical time when its object is handed out, which is the
+ * last moment the cache knows it was released. A free slot is recycled right away,
+ * otherwise the busy slot with the oldest stamp is evicted: it is the one held for the
+ * longest time and the least likely to come back soon.
+ */
+class LruEviction
+{
+    // ──────── ATTRIBUTES ────────────
+protected:
+    std::unique_ptr<std::uint64_t[]> _stamps;
+    std::uint64_t _time = 0;
+
+    // ──────── API ────────────
+public:
+    void resize(std::size_t maxSize)
+    {
+        _stamps = std::make_unique<std::uint64_t[]>(maxSize);
+        _time = 0;
+    }
+
+    void recycled(std::size_t slot) { _stamps[slot] = ++_time; }
+
+    void inserted(std::size_t slot) { _stamps[slot] = ++_time; }
+
+    template<class SharedObject>
+    std::size_t select(const SharedObject* cache, std::size_t size, std::size_t)
+    {
+        std::size_t oldest = 0;
+        for(std::size_t slot = 0; slot < size; ++slot)
+        {
+            if(!cache[slot] || cache[slot].use_count() == 1)
+                return slot;
+            if(_stamps[slot] < _stamps[oldest])
+                oldest = slot;
+        }
+        return oldest;
+    }
+};
+
+}
+
+#endif
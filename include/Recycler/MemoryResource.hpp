@@ -0,0 +1,299 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_MEMORY_RESOURCE_HPP__
+#define __RECYCLER_MEMORY_RESOURCE_HPP__
+
+// std::pmr is only available since C++17
+#if defined(_MSVC_LANG)
+#    define __RECYCLER_CPLUSPLUS _MSVC_LANG
+#else
+#    define __RECYCLER_CPLUSPLUS __cplusplus
+#endif
+
+#if __RECYCLER_CPLUSPLUS >= 201703L && defined(__has_include)
+#    if __has_include(<memory_resource>)
+#        define RECYCLER_HAS_MEMORY_RESOURCE
+#    endif
+#endif
+
+#if defined(RECYCLER_HAS_MEMORY_RESOURCE)
+
+#    include <Recycler/Buffer.hpp>
+#    include <Recycler/Circular.hpp>
+
+#    include <algorithm>
+#    include <cstddef>
+#    include <cstdint>
+#    include <memory>
+#    include <memory_resource>
+#    include <vector>
+
+namespace recycler {
+
+/**
+ * @brief      `std::pmr::memory_resource` backed by `Buffer<std::uint8_t>` chunks recycled through a `Circular`.
+ * Once chunks are warm, `std::pmr` containers allocate without touching the heap.
+ *
+ * Two modes are available:
+ * - `Pooled`: requests are routed to power of two size classes. Each class carves blocks from
+ *   chunks and keeps freed blocks in a free list for the next allocation of the same class.
+ * - `Monotonic`: requests are bumped from the current chunk, `deallocate` does nothing.
+ *   Memory is only given back by `release()`, typically at the end of a frame.
+ *
+ * In both modes `release()` gives every chunk back to the pool. Requests bigger than the largest
+ * size class (or than a chunk) and over aligned requests are forwarded to `upstream`.
+ * Like `std::pmr::unsynchronized_pool_resource`, this resource isn't thread safe.
+ *
+ * @tparam     Pool  Circular pool of `Buffer<std::uint8_t>` that provide chunks
+ */
+template<class Pool = Circular<Buffer<std::uint8_t>>>
+class MemoryResource : public std::pmr::memory_resource
+{
+    // ──────── TYPE ────────────
+public:
+    typedef std::shared_ptr<Buffer<std::uint8_t>> SharedBuffer;
+
+    enum class Mode
+    {
+        Pooled,
+        Monotonic
+    };
+
+    /** @brief Smallest size class, a freed block must be able to hold a free list link */
+    static constexpr std::size_t MIN_BLOCK_SIZE = sizeof(void*) * 2;
+
+protected:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct SizeClass
+    {
+        /** @brief Freed blocks ready to be reused */
+        FreeBlock* free = nullptr;
+        /** @brief Next block never handed out in the last chunk of this class */
+        std::uint8_t* cursor = nullptr;
+        std::uint8_t* end = nullptr;
+    };
+
+    // ──────── CONSTRUCTOR ────────────
+public:
+    /**
+     * @param pool          Pool that provide chunks. It must outlive the resource.
+     * @param mode          Pooled or monotonic allocation
+     * @param chunkSize     Size in bytes of chunks taken from `pool`
+     * @param maxBlockSize  Largest size class in pooled mode. Rounded to a power of two and capped to `chunkSize`.
+     * @param upstream      Resource used for requests that don't fit in a chunk or a size class
+     */
+    MemoryResource(Pool& pool, Mode mode = Mode::Pooled,
+        std::size_t chunkSize = 64 * 1024, std::size_t maxBlockSize = 4096,
+        std::pmr::memory_resource* upstream =
+            std::pmr::get_default_resource()) :
+        _pool(&pool),
+        _mode(mode), _chunkSize(std::max(chunkSize, MIN_BLOCK_SIZE)),
+        _upstream(upstream)
+    {
+        std::size_t classes = 1;
+        for(std::size_t size = MIN_BLOCK_SIZE;
+            size < maxBlockSize && size * 2 <= _chunkSize; size *= 2)
+            ++classes;
+        _classes.resize(classes);
+    }
+
+    MemoryResource(const MemoryResource&) = delete;
+    MemoryResource& operator=(const MemoryResource&) = delete;
+
+    ~MemoryResource() override { release(); }
+
+    // ──────── ATTRIBUTES ────────────
+protected:
+    /** @brief Pool where chunks are taken from */
+    Pool* _pool;
+    Mode _mode;
+    /** @brief Size of chunks taken from `_pool` */
+    std::size_t _chunkSize;
+    std::pmr::memory_resource* _upstream;
+    /** @brief Chunks in use, kept alive until `release()` */
+    std::vector<SharedBuffer> _chunks;
+    /** @brief Size classes of pooled mode, class `i` hand out blocks of `MIN_BLOCK_SIZE << i` bytes */
+    std::vector<SizeClass> _classes;
+    /** @brief Bump pointer of monotonic mode */
+    std::uint8_t* _cursor = nullptr;
+    std::uint8_t* _end = nullptr;
+
+    // ──────── API ────────────
+public:
+    Mode mode() const { return _mode; }
+
+    std::size_t chunkSize() const { return _chunkSize; }
+
+    /**
+     * @brief      Largest request served from chunks in pooled mode
+     */
+    std::size_t maxBlockSize() const
+    {
+        return MIN_BLOCK_SIZE << (_classes.size() - 1);
+    }
+
+    /**
+     * @brief      Number of chunks taken from the pool
+     */
+    std::size_t chunkCount() const { return _chunks.size(); }
+
+    std::pmr::memory_resource* upstream() const { return _upstream; }
+
+    /**
+     * @brief      Give every chunk back to the pool.
+     * All memory allocated from chunks becomes invalid. Memory allocated from upstream isn't released.
+     */
+    void release()
+    {
+        _chunks.clear();
+        for(auto& blocks: _classes) blocks = SizeClass();
+        _cursor = nullptr;
+        _end = nullptr;
+    }
+
+    // ──────── MEMORY RESOURCE ────────────
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if(!bytes)
+            bytes = 1;
+        if(alignment > alignof(std::max_align_t))
+            return _upstream->allocate(bytes, alignment);
+
+        if(_mode == Mode::Monotonic)
+        {
+            if(bytes > _chunkSize)
+                return _upstream->allocate(bytes, alignment);
+            return bump(bytes, alignment);
+        }
+
+        const auto index = sizeClass(bytes, alignment);
+        if(index == _classes.size())
+            return _upstream->allocate(bytes, alignment);
+
+        auto& blocks = _classes[index];
+        if(auto* block = blocks.free)
+        {
+            blocks.free = block->next;
+            return block;
+        }
+
+        const auto blockSize = MIN_BLOCK_SIZE << index;
+        if(blocks.cursor == blocks.end)
+        {
+            auto* chunk = acquire();
+            blocks.cursor = chunk;
+            blocks.end = chunk + _chunkSize / blockSize * blockSize;
+        }
+
+        auto* block = blocks.cursor;
+        blocks.cursor += blockSize;
+        return block;
+    }
+
+    void do_deallocate(
+        void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        if(!bytes)
+            bytes = 1;
+        if(alignment > alignof(std::max_align_t))
+            return _upstream->deallocate(p, bytes, alignment);
+
+        if(_mode == Mode::Monotonic)
+        {
+            if(bytes > _chunkSize)
+                _upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        const auto index = sizeClass(bytes, alignment);
+        if(index == _classes.size())
+            return _upstream->deallocate(p, bytes, alignment);
+
+        auto* block = static_cast<FreeBlock*>(p);
+        block->next = _classes[index].free;
+        _classes[index].free = block;
+    }
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+protected:
+    /**
+     * @brief      Take a chunk from the pool, its memory is kept until `release()`
+     */
+    std::uint8_t* acquire()
+    {
+        _chunks.push_back(_pool->make(_chunkSize, false));
+        return _chunks.back()->buffer();
+    }
+
+    /**
+     * @brief      Index of the smallest size class that can hold `bytes` aligned to `alignment`.
+     * Blocks are only aligned on `std::max_align_t`, like the chunk they are carved from,
+     * not on their size. Over aligned requests never reach this function, they go to upstream.
+     *
+     * @return     `_classes.size()` if no class is big enough
+     */
+    std::size_t sizeClass(std::size_t bytes, std::size_t alignment) const
+    {
+        const auto size = std::max(bytes, alignment);
+        std::size_t index = 0;
+        for(auto blockSize = MIN_BLOCK_SIZE;
+            blockSize < size && index < _classes.size(); blockSize *= 2)
+            ++index;
+        return index;
+    }
+
+    void* bump(std::size_t bytes, std::size_t alignment)
+    {
+        const auto offset =
+            reinterpret_cast<std::uintptr_t>(_cursor) % alignment;
+        std::size_t padding = offset ? alignment - offset : 0;
+        if(!_cursor || std::size_t(_end - _cursor) < padding + bytes)
+        {
+            _cursor = acquire();
+            _end = _cursor + _chunkSize;
+            padding = 0;
+        }
+
+        auto* p = _cursor + padding;
+        _cursor = p + bytes;
+        return p;
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,229 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_MULTI_BUFFER_HPP__
+#define __RECYCLER_MULTI_BUFFER_HPP__
+
+#include <Recycler/Span.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace recycler {
+
+/**
+ * @brief      Several parallel arrays (structure of arrays) that always share one length,
+ * stored in a single allocation. Each column start on a cache line so vectorized loops
+ * over one column never share a line with another column.
+ * Like `Buffer`, memory is only reallocated when growing, and data is lost when it is.
+ * It is made to be recycled by `Circular`: `make(length, clearBuffer)` resize every column at once.
+ *
+ * @tparam     Ts    Type of elements of each column. Must be trivial types like `float` or `std::int32_t`.
+ */
+template<typename... Ts>
+class MultiBuffer
+{
+    // ──────── TYPE ────────────
+public:
+    /** @brief Alignment in bytes of every column */
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    static constexpr std::size_t COLUMNS = sizeof...(Ts);
+
+    template<std::size_t I>
+    using Column = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+    static_assert(COLUMNS > 0, "MultiBuffer requires at least one column");
+
+    // ──────── ATTRIBUTES ────────────
+private:
+    std::unique_ptr<std::uint8_t[]> _storage;
+    /** @brief First element of each column, aligned on `ALIGNMENT` */
+    void* _columns[COLUMNS] = {};
+    std::size_t _length = 0;
+    /** @brief Number of elements each column can hold without reallocation */
+    std::size_t _maxSize = 0;
+
+    // ──────── CONSTRUCTOR ────────────
+public:
+    MultiBuffer(std::size_t length = 0, bool clearBuffer = true)
+    {
+        reset(length, clearBuffer);
+    }
+
+    MultiBuffer(const MultiBuffer&) = delete;
+    MultiBuffer& operator=(const MultiBuffer&) = delete;
+
+    bool reset(std::size_t length, bool clearBuffer = true)
+    {
+        // Newly allocated memory is already value initialized
+        if(!resize(length) && clearBuffer)
+            clearColumns(std::index_sequence_for<Ts...>());
+        return true;
+    }
+
+    // ──────── API ────────────
+public:
+    std::size_t length() const { return _length; }
+
+    std::size_t size() const { return length(); }
+
+    bool empty() const { return length() == 0; }
+
+    std::size_t maxSize() const { return _maxSize; }
+
+    /**
+     * @brief      Elements of column `I`
+     */
+    template<std::size_t I>
+    Span<Column<I>> column()
+    {
+        return Span<Column<I>>(data<I>(), _length);
+    }
+
+    template<std::size_t I>
+    Span<const Column<I>> column() const
+    {
+        return Span<const Column<I>>(data<I>(), _length);
+    }
+
+    template<std::size_t I>
+    Column<I>* data()
+    {
+        return static_cast<Column<I>*>(_columns[I]);
+    }
+
+    template<std::size_t I>
+    const Column<I>* data() const
+    {
+        return static_cast<const Column<I>*>(_columns[I]);
+    }
+
+    /**
+     * @brief      Give back memory that isn't required to hold `length()` elements
+     */
+    void release()
+    {
+        if(_length != _maxSize)
+        {
+            const auto length = _length;
+            resize(0);
+            resize(length);
+        }
+    }
+
+    /**
+     * @brief      Set the length of every column.
+     * Memory is reallocated only if a column is smaller than `length`, data is then lost.
+     *
+     * @return     True if memory was reallocated
+     */
+    bool resize(std::size_t length)
+    {
+        if(length == 0)
+        {
+            _storage = nullptr;
+            std::fill(std::begin(_columns), std::end(_columns), nullptr);
+            _length = 0;
+            _maxSize = 0;
+            return true;
+        }
+
+        _length = length;
+        if(_storage && _maxSize >= length)
+            return false;
+
+        // Extra bytes let the first column be aligned
+        _storage = std::make_unique<std::uint8_t[]>(
+            bytes(length) + ALIGNMENT - 1);
+        _maxSize = length;
+
+        auto* column = align(_storage.get());
+        const std::size_t sizes[] = {sizeof(Ts)...};
+        for(std::size_t i = 0; i < COLUMNS; ++i)
+        {
+            _columns[i] = column;
+            column += roundUp(sizes[i] * length);
+        }
+        return true;
+    }
+
+    void clear() { reset(0); }
+
+    /**
+     * @brief      Bytes required by `length` elements in every column, padding included
+     */
+    static std::size_t bytes(std::size_t length)
+    {
+        const std::size_t sizes[] = {sizeof(Ts)...};
+        std::size_t total = 0;
+        for(const auto size: sizes) total += roundUp(size * length);
+        return total;
+    }
+
+private:
+    static std::size_t roundUp(std::size_t size)
+    {
+        return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    static std::uint8_t* align(std::uint8_t* p)
+    {
+        const auto offset = reinterpret_cast<std::uintptr_t>(p) % ALIGNMENT;
+        return offset ? p + ALIGNMENT - offset : p;
+    }
+
+    template<std::size_t... Is>
+    void clearColumns(std::index_sequence<Is...>)
+    {
+        using expand = int[];
+        (void)expand {
+            0, (std::fill(data<Is>(), data<Is>() + _length, Column<Is>()),
+                   0)...};
+    }
+
+    template<typename T>
+    struct IsColumn
+    {
+        static constexpr bool value = std::is_trivial<T>::value &&
+                                      alignof(T) <= ALIGNMENT;
+    };
+
+    static_assert(std::is_same<std::integer_sequence<bool, true,
+                                   IsColumn<Ts>::value...>,
+                      std::integer_sequence<bool, IsColumn<Ts>::value...,
+                          true>>::value,
+        "MultiBuffer columns must be trivial types aligned on at most "
+        "ALIGNMENT bytes");
+};
+
+}
+
+#endif
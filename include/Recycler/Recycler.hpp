@@ -26,6 +26,16 @@
 #define __RECYCLER_HPP__
 
 #include <Recycler/Circular.hpp>
+#include <Recycler/Eviction.hpp>
+#include <Recycler/Arena.hpp>
 #include <Recycler/Buffer.hpp>
+#include <Recycler/BufferChain.hpp>
+#include <Recycler/MemoryResource.hpp>
+#include <Recycler/MultiBuffer.hpp>
+#include <Recycler/ResetTraits.hpp>
+#include <Recycler/RingBuffer.hpp>
+#include <Recycler/SharedMemoryPool.hpp>
+#include <Recycler/Span.hpp>
+#include <Recycler/Tracer.hpp>
 
 #endif
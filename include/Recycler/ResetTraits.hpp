@@ -0,0 +1,168 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_RESET_TRAITS_HPP__
+#define __RECYCLER_RESET_TRAITS_HPP__
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace recycler {
+
+/**
+ * @brief      How `Circular` prepare a recycled object before handing it out again.
+ * - If `T` has a `reset(args...)` member function, it is called with the arguments given to `make()`.
+ * - Otherwise, when `make()` is called without arguments and `T` has a `clear()` member function
+ *   but no `reset` member at all, `clear()` is called. This let `Circular` recycle standard containers
+ *   (`std::vector`, `std::string`, `std::unordered_map`, ...) while keeping their capacity.
+ *   Types like `Buffer` whose `clear()` frees memory have a `reset`, so they must be given its arguments.
+ *
+ * `reset()` doesn't take part in overload resolution when none of those apply.
+ * Specialize this struct to recycle a type that has neither of those functions.
+ *
+ * @tparam     T     Class of the object in the cache
+ */
+template<class T>
+struct ResetTraits
+{
+private:
+    struct ResetProbe
+    {
+        void reset();
+    };
+
+    template<class U>
+    struct ResetProbeDerived : U, ResetProbe
+    {
+    };
+
+    /**
+     * @brief True if `U` has a `reset` member, whatever its signature.
+     * `&ResetProbeDerived<U>::reset` is only unambiguous when `U` has no `reset` of its own.
+     */
+    template<class U,
+        bool = std::is_class<U>::value && !std::is_final<U>::value,
+        class = void>
+    struct HasResetMember : std::true_type
+    {
+    };
+
+    template<class U>
+    struct HasResetMember<U, true,
+        decltype(void(&ResetProbeDerived<U>::reset))> : std::false_type
+    {
+    };
+
+    template<class U>
+    struct HasResetMember<U, false> : std::false_type
+    {
+    };
+
+    template<class U, typename... Types>
+    static auto resetImpl(int, U& object, Types&&... args)
+        -> decltype(object.reset(std::forward<Types>(args)...), void())
+    {
+        object.reset(std::forward<Types>(args)...);
+    }
+
+    template<class U,
+        class = typename std::enable_if<!HasResetMember<U>::value>::type>
+    static auto resetImpl(long, U& object) -> decltype(object.clear(), void())
+    {
+        object.clear();
+    }
+
+public:
+    template<typename... Types>
+    static auto reset(T& object, Types&&... args)
+        -> decltype(resetImpl(0, object, std::forward<Types>(args)...))
+    {
+        resetImpl(0, object, std::forward<Types>(args)...);
+    }
+};
+
+/**
+ * @brief      Container adapter with a capacity ceiling, for `Circular<Capped<std::vector<int>, 4096>>`.
+ * `reset()` clears the container and keeps its capacity, unless it grew above `MAX_CAPACITY`.
+ * Such an outlier is given back to the heap and replaced by an empty container, so one huge
+ * message doesn't pin its memory in the cache forever.
+ *
+ * Capacity is `capacity()` for `std::vector` and `std::basic_string`, and `bucket_count()`
+ * for unordered containers. Node based containers (`std::map`, `std::list`, ...) free
+ * their nodes on `clear()` so the ceiling doesn't apply to them.
+ *
+ * @tparam     C             Container type
+ * @tparam     MAX_CAPACITY  Largest capacity kept when recycled
+ */
+template<class C, std::size_t MAX_CAPACITY>
+class Capped : public C
+{
+    // ──────── CONSTRUCTOR ────────────
+public:
+    using C::C;
+    Capped() = default;
+
+    // ──────── API ────────────
+public:
+    static constexpr std::size_t maxCapacity() { return MAX_CAPACITY; }
+
+    void reset()
+    {
+        C::clear();
+        shrink(0, static_cast<C&>(*this));
+    }
+
+private:
+    template<class U>
+    static auto shrink(int, U& container)
+        -> decltype(container.capacity(), void())
+    {
+        if(container.capacity() > MAX_CAPACITY)
+            U(container.get_allocator()).swap(container);
+    }
+
+    template<class U>
+    static auto shrink(long, U& container)
+        -> decltype(container.bucket_count(), void())
+    {
+        if(container.bucket_count() > MAX_CAPACITY)
+            container.rehash(0);
+    }
+
+    /** @brief Worse match than `int` and `long`, picked when the container has no capacity */
+    struct NoCapacity
+    {
+        NoCapacity(int) {}
+    };
+
+    template<class U>
+    static void shrink(NoCapacity, U&)
+    {
+    }
+};
+
+}
+
+#endif
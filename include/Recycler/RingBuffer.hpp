@@ -0,0 +1,299 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_RING_BUFFER_HPP__
+#define __RECYCLER_RING_BUFFER_HPP__
+
+// Double mapping relies on memfd_create, only available on Linux
+#if defined(__linux__)
+
+#    include <Recycler/Span.hpp>
+
+#    include <algorithm>
+#    include <atomic>
+#    include <cstddef>
+#    include <cstdint>
+#    include <cstring>
+
+#    include <sys/mman.h>
+#    include <unistd.h>
+
+namespace recycler {
+
+/**
+ * @brief      Byte ring buffer whose memory is mapped twice, back to back.
+ * Any window of up to `length()` bytes starting inside the buffer is contiguous in virtual memory,
+ * so reads and writes that wrap around the end never need two spans or a scratch copy.
+ *
+ * One producer writes in `writeSpan()` then `commit()`, one consumer reads `readSpan()` then `consume()`.
+ * Producer and consumer can live on different threads.
+ *
+ * Raw access behave like `Buffer<std::uint8_t>`: `buffer()` point to the first mapping and
+ * `operator[]` is valid for offsets up to `2 * length()`, byte `i + length()` being byte `i`.
+ * `length()` is the requested length rounded up to the page size.
+ *
+ * Cursors are kept modulo `2 * length()` rather than growing freely. `length()` is only a multiple
+ * of the page size, so a free running `std::size_t` cursor wrapping at 2^32 (32 bits platforms,
+ * after 4GiB of stream) would make `cursor % length()` jump. The extra factor two let a full
+ * ring be told apart from an empty one.
+ */
+class RingBuffer
+{
+    // ──────── CONSTRUCTOR ────────────
+public:
+    RingBuffer(std::size_t length = 0, bool clearBuffer = true)
+    {
+        reset(length, clearBuffer);
+    }
+
+    ~RingBuffer() { unmap(); }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief      Map a buffer of at least `length` bytes and reset cursors.
+     * Memory is only remapped if the page rounded length changes.
+     *
+     * @return     False if mapping failed, the buffer is then empty.
+     */
+    bool reset(std::size_t length, bool clearBuffer = true)
+    {
+        const auto page = std::size_t(::sysconf(_SC_PAGESIZE));
+        const auto mapped = (length + page - 1) / page * page;
+
+        clear();
+        if(mapped != _length)
+        {
+            unmap();
+            if(mapped && !map(mapped))
+                return false;
+        }
+        else if(clearBuffer && _length)
+        {
+            std::memset(_buffer, 0, _length);
+        }
+        return true;
+    }
+
+    // ──────── ATTRIBUTES ────────────
+private:
+    /** @brief First of the two mappings, the second one follow at `_buffer + _length` */
+    std::uint8_t* _buffer = nullptr;
+    std::size_t _length = 0;
+    /** @brief Bytes committed by producer, modulo `2 * _length` */
+    std::atomic<std::size_t> _write {0};
+    /** @brief Bytes consumed by consumer, modulo `2 * _length` */
+    std::atomic<std::size_t> _read {0};
+
+    // ──────── API ────────────
+public:
+    std::uint8_t* buffer() { return _buffer; }
+
+    const std::uint8_t* buffer() const { return _buffer; }
+
+    std::size_t length() const { return _length; }
+
+    std::size_t size() const { return length(); }
+
+    bool empty() const { return length() == 0; }
+
+    std::size_t maxSize() const { return _length; }
+
+    /**
+     * @brief      Number of bytes that can be read. Can be called by producer or consumer.
+     */
+    std::size_t readable() const
+    {
+        return distance(_write.load(std::memory_order_acquire),
+            _read.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief      Number of bytes that can be written. Can be called by producer or consumer.
+     */
+    std::size_t writable() const { return _length - readable(); }
+
+    /**
+     * @brief      Contiguous free space after the last committed byte. Producer only.
+     */
+    Span<std::uint8_t> writeSpan()
+    {
+        const auto write = _write.load(std::memory_order_relaxed);
+        const auto read = _read.load(std::memory_order_acquire);
+        if(!_length)
+            return Span<std::uint8_t>();
+        return Span<std::uint8_t>(
+            _buffer + position(write), _length - distance(write, read));
+    }
+
+    /**
+     * @brief      Make `length` bytes written in `writeSpan()` readable. Producer only.
+     * `length` is clamped to `writable()`.
+     */
+    void commit(std::size_t length)
+    {
+        // Only the producer moves `_write`
+        const auto write = _write.load(std::memory_order_relaxed);
+        _write.store(advance(write, std::min(length, writable())),
+            std::memory_order_release);
+    }
+
+    /**
+     * @brief      Contiguous readable bytes. Consumer only.
+     */
+    Span<const std::uint8_t> readSpan() const
+    {
+        const auto read = _read.load(std::memory_order_relaxed);
+        const auto write = _write.load(std::memory_order_acquire);
+        if(!_length)
+            return Span<const std::uint8_t>();
+        return Span<const std::uint8_t>(
+            _buffer + position(read), distance(write, read));
+    }
+
+    /**
+     * @brief      Drop `length` bytes of `readSpan()` so producer can write there again. Consumer only.
+     * `length` is clamped to `readable()`.
+     */
+    void consume(std::size_t length)
+    {
+        // Only the consumer moves `_read`
+        const auto read = _read.load(std::memory_order_relaxed);
+        _read.store(advance(read, std::min(length, readable())),
+            std::memory_order_release);
+    }
+
+    /**
+     * @brief      Drop all readable bytes. Producer and consumer must not be running.
+     */
+    void clear()
+    {
+        _write.store(0, std::memory_order_relaxed);
+        _read.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief      Unmap memory
+     */
+    void release()
+    {
+        clear();
+        unmap();
+    }
+
+    // ──────── ACCESSOR ────────────
+public:
+    std::uint8_t& operator[](const std::size_t offset) { return _buffer[offset]; }
+
+    const std::uint8_t& operator[](const std::size_t offset) const
+    {
+        return _buffer[offset];
+    }
+
+    operator std::uint8_t*() { return _buffer; }
+    operator const std::uint8_t*() const { return _buffer; }
+
+    std::uint8_t* begin() { return _buffer; }
+    std::uint8_t* end() { return _buffer + _length; }
+    const std::uint8_t* cbegin() const { return _buffer; }
+    const std::uint8_t* cend() const { return _buffer + _length; }
+
+private:
+    /**
+     * @brief      Bytes between cursors `to` and `from`, both modulo `2 * _length`
+     */
+    std::size_t distance(std::size_t to, std::size_t from) const
+    {
+        return to >= from ? to - from : to + 2 * _length - from;
+    }
+
+    /**
+     * @brief      Move `cursor` forward by `count` bytes, with `count <= _length`
+     */
+    std::size_t advance(std::size_t cursor, std::size_t count) const
+    {
+        cursor += count;
+        return cursor >= 2 * _length ? cursor - 2 * _length : cursor;
+    }
+
+    /**
+     * @brief      Offset of `cursor` in the first mapping
+     */
+    std::size_t position(std::size_t cursor) const
+    {
+        return cursor >= _length ? cursor - _length : cursor;
+    }
+
+    /**
+     * @brief      Reserve `2 * length` bytes of address space, then map the same memfd twice in it
+     */
+    bool map(std::size_t length)
+    {
+        const int fd = ::memfd_create("recycler-ring-buffer", MFD_CLOEXEC);
+        if(fd < 0)
+            return false;
+
+        bool success = false;
+        void* base = MAP_FAILED;
+        if(::ftruncate(fd, off_t(length)) == 0)
+            base = ::mmap(nullptr, 2 * length, PROT_NONE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if(base != MAP_FAILED)
+        {
+            auto* first = static_cast<std::uint8_t*>(base);
+            success = ::mmap(first, length, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                      ::mmap(first + length, length, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+            if(success)
+            {
+                _buffer = first;
+                _length = length;
+            }
+            else
+            {
+                ::munmap(base, 2 * length);
+            }
+        }
+
+        ::close(fd);
+        return success;
+    }
+
+    void unmap()
+    {
+        if(_buffer)
+            ::munmap(_buffer, 2 * _length);
+        _buffer = nullptr;
+        _length = 0;
+    }
+};
+
+}
+
+#endif
+
+#endif
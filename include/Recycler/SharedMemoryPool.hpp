@@ -0,0 +1,488 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_SHARED_MEMORY_POOL_HPP__
+#define __RECYCLER_SHARED_MEMORY_POOL_HPP__
+
+// Named shared memory relies on POSIX shm_open
+#if !defined(_WIN32)
+
+#    include <atomic>
+#    include <cstddef>
+#    include <cstdint>
+#    include <new>
+#    include <string>
+
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+
+namespace recycler {
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+    "SharedMemoryPool requires lock free atomic to share refcounts between processes");
+
+/**
+ * @brief      Recycling pool whose blocks, slot table and refcounts live in a named POSIX shared memory segment.
+ * One process `create()` the segment, others `open()` it. Any process can take a free block with `make()`,
+ * hand it to another process by its offset, and give it back by dropping its last `Block`.
+ * Acquiring and releasing a block only use atomics inside the segment, no copy and no system call.
+ *
+ * Unlike `Circular`, the pool can't grow: `make()` returns an invalid block when every block is in use.
+ */
+class SharedMemoryPool
+{
+    // ──────── TYPE ────────────
+protected:
+    static constexpr std::uint64_t MAGIC = 0x52435943534d504cull;
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    struct Header
+    {
+        std::uint64_t magic;
+        std::uint64_t slotCount;
+        std::uint64_t blockSize;
+        std::uint64_t blocksOffset;
+        /** @brief Slot where next `make()` start looking, like `Circular::_idx` */
+        std::atomic<std::uint32_t> next;
+        /** @brief Set by creator once the segment is initialized */
+        std::atomic<std::uint32_t> ready;
+    };
+
+    struct alignas(ALIGNMENT) Slot
+    {
+        /** @brief Number of `Block` referencing this slot, in every process */
+        std::atomic<std::uint32_t> refs;
+        /** @brief Bytes used in the block */
+        std::uint64_t length;
+    };
+
+public:
+    /**
+     * @brief      Reference on a block of the pool, similar to a `std::shared_ptr<Buffer<std::uint8_t>>`.
+     * Copies share the block, the block goes back to the pool when the last reference of every process is dropped.
+     */
+    class Block
+    {
+        friend class SharedMemoryPool;
+
+        // ──────── CONSTRUCTOR ────────────
+    public:
+        Block() = default;
+        Block(const Block& other) : _pool(other._pool), _slot(other._slot)
+        {
+            if(_pool)
+                _pool->retain(_slot);
+        }
+        Block(Block&& other) noexcept : _pool(other._pool), _slot(other._slot)
+        {
+            other._pool = nullptr;
+        }
+        Block& operator=(const Block& other)
+        {
+            if(this != &other)
+            {
+                reset();
+                _pool = other._pool;
+                _slot = other._slot;
+                if(_pool)
+                    _pool->retain(_slot);
+            }
+            return *this;
+        }
+        Block& operator=(Block&& other) noexcept
+        {
+            if(this != &other)
+            {
+                reset();
+                _pool = other._pool;
+                _slot = other._slot;
+                other._pool = nullptr;
+            }
+            return *this;
+        }
+        ~Block() { reset(); }
+
+    private:
+        Block(const SharedMemoryPool* pool, std::size_t slot) :
+            _pool(pool), _slot(slot)
+        {
+        }
+
+        // ──────── ATTRIBUTES ────────────
+    private:
+        const SharedMemoryPool* _pool = nullptr;
+        std::size_t _slot = 0;
+
+        // ──────── API ────────────
+    public:
+        bool valid() const { return _pool != nullptr; }
+        explicit operator bool() const { return valid(); }
+
+        std::uint8_t* buffer() const { return _pool->block(_slot); }
+
+        /** @brief Bytes used in the block, visible from every process */
+        std::size_t length() const { return _pool->slot(_slot).length; }
+
+        std::size_t size() const { return length(); }
+
+        bool empty() const { return length() == 0; }
+
+        std::size_t maxSize() const { return _pool->blockSize(); }
+
+        /**
+         * @brief      Set bytes used in the block. No allocation ever happen.
+         *
+         * @return     False if `length` is bigger than `maxSize()`
+         */
+        bool resize(std::size_t length)
+        {
+            if(length > maxSize())
+                return false;
+            _pool->slot(_slot).length = length;
+            return true;
+        }
+
+        /** @brief Handle of the block, valid in every process attached to the pool */
+        std::uint64_t offset() const { return _pool->offset(_slot); }
+
+        /** @brief Number of references on the block, in every process */
+        std::size_t useCount() const
+        {
+            return _pool->slot(_slot).refs.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief      Give up this reference without releasing it, to transfer it to another process.
+         * The other process takes it back with `SharedMemoryPool::adopt()`.
+         *
+         * @return     Handle of the block
+         */
+        std::uint64_t detach()
+        {
+            const auto handle = offset();
+            _pool = nullptr;
+            return handle;
+        }
+
+        /** @brief Drop this reference */
+        void reset()
+        {
+            if(_pool)
+                _pool->release(_slot);
+            _pool = nullptr;
+        }
+
+        std::uint8_t& operator[](const std::size_t offset) const
+        {
+            return buffer()[offset];
+        }
+
+        operator std::uint8_t*() const { return buffer(); }
+    };
+
+    // ──────── CONSTRUCTOR ────────────
+public:
+    SharedMemoryPool() = default;
+    ~SharedMemoryPool() { close(); }
+
+    SharedMemoryPool(const SharedMemoryPool&) = delete;
+    SharedMemoryPool& operator=(const SharedMemoryPool&) = delete;
+
+    // ──────── ATTRIBUTES ────────────
+protected:
+    std::uint8_t* _segment = nullptr;
+    std::size_t _segmentSize = 0;
+    /** @brief Name of the segment if this process created it. It is unlinked on `close()` */
+    std::string _owned;
+
+    // ──────── API ────────────
+public:
+    /**
+     * @brief      Create and map the named segment `name` (for example "/my-pool").
+     * Segment is unlinked when this pool is closed, processes that already opened it keep their mapping.
+     *
+     * @param name          Name of the segment, must not exist
+     * @param slotCount     Number of blocks in the pool
+     * @param blockSize     Maximum size in bytes of each block
+     *
+     * @return     False if segment already exist or can't be created
+     */
+    bool create(const std::string& name, std::size_t slotCount, std::size_t blockSize)
+    {
+        close();
+        if(!slotCount || slotCount > UINT32_MAX || !blockSize)
+            return false;
+
+        blockSize = align(blockSize);
+        const auto blocksOffset =
+            align(sizeof(Header)) + slotCount * sizeof(Slot);
+        const auto segmentSize = blocksOffset + slotCount * blockSize;
+
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(fd < 0)
+            return false;
+
+        if(::ftruncate(fd, off_t(segmentSize)) != 0 || !map(fd, segmentSize))
+        {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            return false;
+        }
+        ::close(fd);
+        _owned = name;
+
+        auto* header = new(_segment) Header();
+        header->magic = MAGIC;
+        header->slotCount = slotCount;
+        header->blockSize = blockSize;
+        header->blocksOffset = blocksOffset;
+        for(std::size_t i = 0; i < slotCount; ++i)
+            new(_segment + align(sizeof(Header)) + i * sizeof(Slot)) Slot();
+        header->next.store(0, std::memory_order_relaxed);
+        header->ready.store(1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief      Map a segment created by another process with `create()`
+     *
+     * @return     False if segment doesn't exist or isn't initialized yet
+     */
+    bool open(const std::string& name)
+    {
+        close();
+
+        const int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        if(fd < 0)
+            return false;
+
+        struct stat st;
+        const bool mapped = ::fstat(fd, &st) == 0 &&
+                            std::size_t(st.st_size) >= sizeof(Header) &&
+                            map(fd, std::size_t(st.st_size));
+        ::close(fd);
+        if(!mapped)
+            return false;
+
+        // Header comes from another process, don't trust sizes it contains
+        const auto* h = header();
+        if(h->ready.load(std::memory_order_acquire) != 1 || h->magic != MAGIC ||
+            !h->slotCount || !h->blockSize ||
+            h->blocksOffset < align(sizeof(Header)) ||
+            h->blocksOffset > _segmentSize ||
+            h->slotCount > (_segmentSize - h->blocksOffset) / h->blockSize ||
+            h->slotCount >
+                (h->blocksOffset - align(sizeof(Header))) / sizeof(Slot))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief      Unmap the segment, and unlink it if it was created by this pool.
+     * All `Block` of this pool must be dropped before.
+     */
+    void close()
+    {
+        if(_segment)
+            ::munmap(_segment, _segmentSize);
+        _segment = nullptr;
+        _segmentSize = 0;
+        if(!_owned.empty())
+            ::shm_unlink(_owned.c_str());
+        _owned.clear();
+    }
+
+    bool isOpen() const { return _segment != nullptr; }
+
+    /**
+     * @brief      Number of blocks in the segment, 0 if the pool isn't open
+     */
+    std::size_t slotCount() const
+    {
+        return _segment ? std::size_t(header()->slotCount) : 0;
+    }
+
+    /**
+     * @brief      Size in bytes of each block, 0 if the pool isn't open
+     */
+    std::size_t blockSize() const
+    {
+        return _segment ? std::size_t(header()->blockSize) : 0;
+    }
+
+    /**
+     * @brief      Number of blocks currently in use, in every process
+     */
+    std::size_t size() const
+    {
+        if(!_segment)
+            return 0;
+        std::size_t count = 0;
+        for(std::size_t i = 0; i < slotCount(); ++i)
+            count += slot(i).refs.load(std::memory_order_relaxed) != 0;
+        return count;
+    }
+
+    /**
+     * @brief      Take a free block and set its length.
+     * Like `Circular::make()`, search start after the last block handed out.
+     *
+     * @return     Invalid block if every block is in use or `length` is bigger than `blockSize()`
+     */
+    Block make(std::size_t length = 0)
+    {
+        if(!_segment || length > blockSize())
+            return Block();
+
+        auto* h = header();
+        const auto count = slotCount();
+        const auto start = h->next.load(std::memory_order_relaxed);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const auto index = (start + i) % count;
+            auto& s = slot(index);
+            std::uint32_t expected = 0;
+            if(s.refs.load(std::memory_order_relaxed) == 0 &&
+                s.refs.compare_exchange_strong(expected, 1,
+                    std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                h->next.store(std::uint32_t((index + 1) % count),
+                    std::memory_order_relaxed);
+                s.length = length;
+                return Block(this, index);
+            }
+        }
+        return Block();
+    }
+
+    /**
+     * @brief      Take a new reference on the block at `offset`, that is already referenced by someone else.
+     * The sender must keep its reference until the block is attached: once freed, the block can be
+     * handed out again by `make()` in any process.
+     *
+     * @return     Invalid block if `offset` isn't a block handle of this pool, or if the block is free
+     */
+    Block attach(std::uint64_t offset) const
+    {
+        std::size_t index = 0;
+        if(!slotAt(offset, index) || !tryRetain(index))
+            return Block();
+        return Block(this, index);
+    }
+
+    /**
+     * @brief      Take over a reference given up with `Block::detach()`, possibly by another process
+     *
+     * @return     Invalid block if `offset` isn't a block handle of this pool
+     */
+    Block adopt(std::uint64_t offset) const
+    {
+        std::size_t index = 0;
+        if(!slotAt(offset, index))
+            return Block();
+        return Block(this, index);
+    }
+
+protected:
+    static std::size_t align(std::size_t size)
+    {
+        return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    bool map(int fd, std::size_t size)
+    {
+        void* segment =
+            ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(segment == MAP_FAILED)
+            return false;
+        _segment = static_cast<std::uint8_t*>(segment);
+        _segmentSize = size;
+        return true;
+    }
+
+    Header* header() const { return reinterpret_cast<Header*>(_segment); }
+
+    Slot& slot(std::size_t index) const
+    {
+        return reinterpret_cast<Slot*>(_segment + align(sizeof(Header)))[index];
+    }
+
+    std::uint8_t* block(std::size_t index) const
+    {
+        return _segment + offset(index);
+    }
+
+    std::uint64_t offset(std::size_t index) const
+    {
+        return header()->blocksOffset + index * header()->blockSize;
+    }
+
+    bool slotAt(std::uint64_t offset, std::size_t& index) const
+    {
+        if(!_segment || offset < header()->blocksOffset)
+            return false;
+        const auto relative = offset - header()->blocksOffset;
+        if(relative % header()->blockSize)
+            return false;
+        index = std::size_t(relative / header()->blockSize);
+        return index < slotCount();
+    }
+
+    void retain(std::size_t index) const
+    {
+        slot(index).refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief      Take a reference only if the block is still in use, so a free block never come back to life
+     */
+    bool tryRetain(std::size_t index) const
+    {
+        auto& refs = slot(index).refs;
+        auto count = refs.load(std::memory_order_relaxed);
+        while(count)
+        {
+            if(refs.compare_exchange_weak(count, count + 1,
+                   std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    void release(std::size_t index) const
+    {
+        slot(index).refs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_SPAN_HPP__
+#define __RECYCLER_SPAN_HPP__
+
+#include <cstddef>
+
+namespace recycler {
+
+/**
+ * @brief      Non owning view over `length` contiguous objects.
+ * Minimal C++14 replacement of `std::span`.
+ *
+ * @tparam     T     Type of viewed objects, can be const
+ */
+template<typename T>
+class Span
+{
+    // ──────── ATTRIBUTES ────────────
+private:
+    T* _data = nullptr;
+    std::size_t _length = 0;
+
+    // ──────── CONSTRUCTOR ────────────
+public:
+    Span() = default;
+    Span(T* data, std::size_t length) : _data(data), _length(length) {}
+
+    // ──────── API ────────────
+public:
+    T* data() const { return _data; }
+
+    std::size_t length() const { return _length; }
+
+    std::size_t size() const { return length(); }
+
+    bool empty() const { return _length == 0; }
+
+    T& operator[](const std::size_t offset) const { return _data[offset]; }
+
+    T* begin() const { return _data; }
+    T* end() const { return _data + _length; }
+};
+
+}
+
+#endif
@@ -0,0 +1,428 @@
+//
+// MIT License
+//
+// Copyright (c) 2021 Olivier Le Doeuff
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef __RECYCLER_TRACER_HPP__
+#define __RECYCLER_TRACER_HPP__
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define __RECYCLER_TRACE_CONCAT_IMPL(a, b) a##b
+#define __RECYCLER_TRACE_CONCAT(a, b) __RECYCLER_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(RECYCLER_ENABLE_TRACING)
+/**
+ * @brief Name the call site of every `Circular::make()` done until the end of the current scope
+ */
+#    define RECYCLER_TRACE_SITE(name)                                          \
+        const ::recycler::TraceSite __RECYCLER_TRACE_CONCAT(                   \
+            __recyclerTraceSite, __LINE__)(name)
+#else
+#    define RECYCLER_TRACE_SITE(name)
+#endif
+
+namespace recycler {
+
+/**
+ * @brief      Scoped name of the code acquiring objects from a `Circular`.
+ * The name is stored per thread, so it is attached to every object acquired by this thread
+ * while the `TraceSite` is alive. Use it through `RECYCLER_TRACE_SITE(name)`.
+ * `name` must have static storage duration, like a string literal.
+ */
+class TraceSite
+{
+    // ──────── CONSTRUCTOR ────────────
+public:
+    TraceSite(const char* name) : _previous(current()) { current() = name; }
+    ~TraceSite() { current() = _previous; }
+
+    TraceSite(const TraceSite&) = delete;
+    TraceSite& operator=(const TraceSite&) = delete;
+
+    // ──────── ATTRIBUTES ────────────
+private:
+    const char* _previous;
+
+    // ──────── API ────────────
+public:
+    static const char*& current()
+    {
+        static thread_local const char* site = nullptr;
+        return site;
+    }
+};
+
+/**
+ * @brief      Record lifetime of objects handed out by a `Circular`.
+ * Every acquire/release pair is a hold. The tracer keeps a log2 histogram of hold times,
+ * statistics per call site, objects that are still held, and objects that were evicted from
+ * the cache while still in use. Holds can be exported as Chrome trace event JSON
+ * (`chrome://tracing`, Perfetto) to see pool residency over time.
+ *
+ * Only used by `Circular` when `RECYCLER_ENABLE_TRACING` is defined. All functions are thread safe.
+ */
+class Tracer
+{
+    // ──────── TYPE ────────────
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /** @brief Number of buckets in `histogram()`. Bucket `i` count holds in [2^i, 2^(i+1)) µs, bucket 0 also count holds under 1µs */
+    static constexpr std::size_t HISTOGRAM_SIZE = 32;
+
+    struct Hold
+    {
+        const void* object;
+        const char* site;
+        Clock::time_point acquired;
+        Clock::time_point released;
+    };
+
+    struct Outstanding
+    {
+        const void* object;
+        const char* site;
+        Clock::duration held;
+    };
+
+    struct SiteStats
+    {
+        const char* site;
+        std::size_t count;
+        Clock::duration total;
+        Clock::duration max;
+    };
+
+    struct Eviction
+    {
+        const void* object;
+        Clock::time_point time;
+    };
+
+protected:
+    struct Active
+    {
+        const void* object;
+        const char* site;
+        Clock::time_point acquired;
+    };
+
+    // ──────── CONSTRUCTOR ────────────
+public:
+    /**
+     * @param maxEvents     Maximum number of holds and evictions kept for `writeChromeTrace()`.
+     * Statistics keep being updated once reached.
+     */
+    Tracer(std::size_t maxEvents = 65536) : _maxEvents(maxEvents) {}
+
+    // ──────── ATTRIBUTES ────────────
+protected:
+    mutable std::mutex _mutex;
+    std::size_t _maxEvents;
+    Clock::time_point _epoch = Clock::now();
+    std::uint64_t _nextId = 0;
+    std::unordered_map<std::uint64_t, Active> _active;
+    std::vector<Hold> _holds;
+    std::vector<Eviction> _evictions;
+    /** @brief Keyed by site pointer so `release()` doesn't allocate. Sites are merged by name in `sites()` */
+    std::unordered_map<const char*, SiteStats> _sites;
+    std::size_t _histogram[HISTOGRAM_SIZE] = {};
+    std::size_t _acquired = 0;
+    std::size_t _released = 0;
+    std::size_t _evicted = 0;
+
+    // ──────── RECORD ────────────
+public:
+    /**
+     * @brief      Record that `object` has been handed out.
+     *
+     * @return     Id of the hold to give to `release()`
+     */
+    std::uint64_t acquire(const void* object, const char* site)
+    {
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto id = _nextId++;
+        _active[id] = Active {object, site ? site : "unknown", now};
+        ++_acquired;
+        return id;
+    }
+
+    /**
+     * @brief      Record that the last user reference of hold `id` has been dropped
+     */
+    void release(std::uint64_t id)
+    {
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = _active.find(id);
+        if(it == _active.end())
+            return;
+
+        const auto active = it->second;
+        _active.erase(it);
+        ++_released;
+
+        const auto held = now - active.acquired;
+        ++_histogram[bucket(held)];
+
+        auto& stats = _sites[active.site];
+        if(!stats.count)
+            stats = SiteStats {active.site, 0, Clock::duration::zero(),
+                Clock::duration::zero()};
+        ++stats.count;
+        stats.total += held;
+        stats.max = std::max(stats.max, held);
+
+        if(_holds.size() < _maxEvents)
+            _holds.push_back(
+                Hold {active.object, active.site, active.acquired, now});
+    }
+
+    /**
+     * @brief      Record that `object` was removed from the cache while still in use.
+     * The cache will have to allocate again to replace it.
+     */
+    void evict(const void* object)
+    {
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_evicted;
+        if(_evictions.size() < _maxEvents)
+            _evictions.push_back(Eviction {object, now});
+    }
+
+    /**
+     * @brief      Forget everything recorded so far. Objects still held won't be reported on release.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _epoch = Clock::now();
+        _active.clear();
+        _holds.clear();
+        _evictions.clear();
+        _sites.clear();
+        std::fill(std::begin(_histogram), std::end(_histogram), 0);
+        _acquired = 0;
+        _released = 0;
+        _evicted = 0;
+    }
+
+    // ──────── REPORT ────────────
+public:
+    std::size_t acquired() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _acquired;
+    }
+
+    std::size_t released() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _released;
+    }
+
+    std::size_t evicted() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _evicted;
+    }
+
+    /**
+     * @brief      Hold time distribution. See `HISTOGRAM_SIZE` for bucket boundaries.
+     */
+    std::vector<std::size_t> histogram() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return std::vector<std::size_t>(
+            std::begin(_histogram), std::end(_histogram));
+    }
+
+    /**
+     * @brief      Statistics of released holds per call site, sorted by longest hold first.
+     * Sites with the same name but a different address (same literal in several translation units)
+     * are merged.
+     */
+    std::vector<SiteStats> sites() const
+    {
+        std::map<std::string, SiteStats> merged;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(const auto& it: _sites)
+            {
+                auto& stats = merged[it.second.site];
+                if(!stats.count)
+                    stats = it.second;
+                else
+                {
+                    stats.count += it.second.count;
+                    stats.total += it.second.total;
+                    stats.max = std::max(stats.max, it.second.max);
+                }
+            }
+        }
+
+        std::vector<SiteStats> result;
+        for(const auto& it: merged) result.push_back(it.second);
+        std::sort(result.begin(), result.end(),
+            [](const SiteStats& a, const SiteStats& b) { return a.max > b.max; });
+        return result;
+    }
+
+    /**
+     * @brief      Objects held for at least `threshold`, longest held first.
+     * Those are the one that are likely leaked or that make the cache grow.
+     */
+    std::vector<Outstanding> outstanding(
+        Clock::duration threshold = Clock::duration::zero()) const
+    {
+        const auto now = Clock::now();
+        std::vector<Outstanding> result;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(const auto& it: _active)
+            {
+                const auto held = now - it.second.acquired;
+                if(held >= threshold)
+                    result.push_back(
+                        Outstanding {it.second.object, it.second.site, held});
+            }
+        }
+        std::sort(result.begin(), result.end(),
+            [](const Outstanding& a, const Outstanding& b) {
+                return a.held > b.held;
+            });
+        return result;
+    }
+
+    /**
+     * @brief      Write recorded holds as Chrome trace event JSON.
+     * Each object get its own row, each hold is a complete event named after its call site.
+     * Objects still held are written up to now. Evictions are instant events.
+     */
+    void writeChromeTrace(std::ostream& os) const
+    {
+        const auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::unordered_map<const void*, std::size_t> rows;
+        const auto row = [&rows](const void* object) {
+            return rows.emplace(object, rows.size() + 1).first->second;
+        };
+
+        bool first = true;
+        const auto separator = [&first, &os]() {
+            if(!first)
+                os << ",\n";
+            first = false;
+        };
+
+        const auto writeHold = [&](const void* object, const char* site,
+                                   Clock::time_point acquired,
+                                   Clock::time_point released) {
+            separator();
+            os << "{\"name\":\"";
+            writeEscaped(os, site);
+            os << "\",\"cat\":\"hold\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+               << row(object) << ",\"ts\":" << micro(acquired - _epoch)
+               << ",\"dur\":" << micro(released - acquired)
+               << ",\"args\":{\"object\":\"" << object << "\"}}";
+        };
+
+        os << "{\"traceEvents\":[\n";
+        for(const auto& hold: _holds)
+            writeHold(hold.object, hold.site, hold.acquired, hold.released);
+        for(const auto& it: _active)
+            writeHold(it.second.object, it.second.site, it.second.acquired, now);
+        for(const auto& eviction: _evictions)
+        {
+            separator();
+            os << "{\"name\":\"evict\",\"cat\":\"evict\",\"ph\":\"i\",\"s\":"
+                  "\"t\",\"pid\":1,\"tid\":"
+               << row(eviction.object)
+               << ",\"ts\":" << micro(eviction.time - _epoch) << "}";
+        }
+        os << "\n]}\n";
+    }
+
+    /**
+     * @brief      Write Chrome trace event JSON to `path`
+     *
+     * @return     True if the file could be written
+     */
+    bool writeChromeTrace(const std::string& path) const
+    {
+        std::ofstream file(path);
+        if(!file)
+            return false;
+        writeChromeTrace(file);
+        return bool(file);
+    }
+
+protected:
+    static std::size_t bucket(Clock::duration held)
+    {
+        auto us = std::uint64_t(micro(held));
+        std::size_t i = 0;
+        while(us > 1 && i + 1 < HISTOGRAM_SIZE)
+        {
+            us >>= 1;
+            ++i;
+        }
+        return i;
+    }
+
+    static long long micro(Clock::duration d)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    }
+
+    static void writeEscaped(std::ostream& os, const char* str)
+    {
+        for(; *str; ++str)
+        {
+            const auto c = *str;
+            if(c == '"' || c == '\\')
+                os << '\\' << c;
+            else if(static_cast<unsigned char>(c) < 0x20)
+                os << ' ';
+            else
+                os << c;
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+// Application Headers
+#include <Recycler/Arena.hpp>
+
+// C++ Headers
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace recycler;
+
+struct Temporary
+{
+    Temporary() = default;
+    Temporary(int id) : id(id) {}
+    void reset(int id) { this->id = id; }
+
+    float x = 0.f;
+    float y = 0.f;
+    float z = 0.f;
+    int id = 0;
+};
+
+template<typename F>
+static long long measure(int frames, F&& frame)
+{
+    const std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+    for(int i = 0; i < frames; ++i) frame();
+    const std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+        .count();
+}
+
+// Every frame create OBJECTS temporaries that all die at the end of the frame
+template<std::size_t OBJECTS>
+void benchmarkArena(int frames)
+{
+    Circular<Temporary, OBJECTS> cache;
+    std::vector<std::shared_ptr<Temporary>> shared;
+    shared.reserve(OBJECTS);
+
+    const auto us1 = measure(frames, [&]() {
+        for(std::size_t i = 0; i < OBJECTS; ++i)
+            shared.push_back(cache.make(int(i)));
+        shared.clear();
+    });
+
+    Circular<Buffer<std::uint8_t>> pool;
+    Arena<> arena(pool);
+    std::vector<Temporary*> raw;
+    raw.reserve(OBJECTS);
+
+    const auto us2 = measure(frames, [&]() {
+        for(std::size_t i = 0; i < OBJECTS; ++i)
+            raw.push_back(arena.make<Temporary>(int(i)));
+        raw.clear();
+        arena.reset();
+    });
+
+    std::cout << "Circular Perf <" << OBJECTS << ">   \t" << us1 << " [us]"
+              << std::endl;
+    std::cout << "Arena Perf    <" << OBJECTS << ">   \t" << us2 << " [us]"
+              << std::endl;
+    std::cout << "Arena is " << (float(us1) / float(us2)) << " times faster"
+              << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    benchmarkArena<16>(20000);
+    benchmarkArena<256>(2000);
+    benchmarkArena<4096>(100);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <Recycler/Arena.hpp>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace recycler;
+
+typedef Circular<Buffer<std::uint8_t>, 8> ChunkPool;
+
+struct Point
+{
+    Point(int x, int y) : x(x), y(y) {}
+    int x;
+    int y;
+};
+
+struct Counted
+{
+    Counted(std::vector<int>& log, int id) : log(&log), id(id) {}
+    ~Counted() { log->push_back(id); }
+    std::vector<int>* log;
+    int id;
+};
+
+TEST(Arena, make_in_place)
+{
+    ChunkPool pool;
+    Arena<ChunkPool> arena(pool, 256);
+
+    auto* p = arena.make<Point>(1, 2);
+    ASSERT_EQ(p->x, 1);
+    ASSERT_EQ(p->y, 2);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignof(Point), 0);
+
+    auto* s = arena.make<std::string>("hello world, long enough to allocate");
+    ASSERT_EQ(*s, "hello world, long enough to allocate");
+    ASSERT_EQ(arena.chunkCount(), 1);
+}
+
+TEST(Arena, alignment)
+{
+    ChunkPool pool;
+    Arena<ChunkPool> arena(pool, 256);
+
+    arena.allocate(1, 1);
+    auto* p = arena.allocate(8, 64);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0);
+    auto* q = arena.allocate(3, 1);
+    ASSERT_EQ(static_cast<std::uint8_t*>(q), static_cast<std::uint8_t*>(p) + 8);
+}
+
+TEST(Arena, destructors_on_reset)
+{
+    ChunkPool pool;
+    Arena<ChunkPool> arena(pool, 256);
+    std::vector<int> log;
+
+    arena.make<Counted>(log, 1);
+    arena.make<Point>(0, 0);
+    arena.make<Counted>(log, 2);
+    ASSERT_TRUE(log.empty());
+
+    arena.reset();
+    ASSERT_EQ(log, std::vector<int>({2, 1}));
+    ASSERT_EQ(arena.chunkCount(), 1);
+    ASSERT_EQ(arena.used(), 0);
+
+    // Destructors already run aren't run again
+    arena.reset();
+    ASSERT_EQ(log.size(), 2);
+}
+
+TEST(Arena, destructors_on_destruction)
+{
+    ChunkPool pool;
+    std::vector<int> log;
+    {
+        Arena<ChunkPool> arena(pool, 256);
+        arena.make<Counted>(log, 1);
+    }
+    ASSERT_EQ(log, std::vector<int>({1}));
+}
+
+TEST(Arena, make_array)
+{
+    ChunkPool pool;
+    Arena<ChunkPool> arena(pool, 256);
+
+    auto* values = arena.makeArray<int>(16);
+    for(int i = 0; i < 16; ++i) ASSERT_EQ(values[i], 0);
+
+    auto* strings = arena.makeArray<std::string>(4);
+    strings[3] = "last";
+    ASSERT_TRUE(strings[0].empty());
+    arena.reset();
+}
+
+TEST(Arena, chunks_from_pool)
+{
+    ChunkPool pool;
+    Arena<ChunkPool> arena(pool, 64);
+
+    // Frames that fit in the first chunk never go back to the pool
+    for(int frame = 0; frame < 100; ++frame)
+    {
+        for(int i = 0; i < 8; ++i) arena.make<Point>(i, i);
+        ASSERT_EQ(arena.chunkCount(), 1);
+        arena.reset();
+    }
+    ASSERT_EQ(pool.size(), 1);
+
+    for(int frame = 0; frame < 100; ++frame)
+    {
+        for(int i = 0; i < 20; ++i) arena.make<Point>(i, i);
+        ASSERT_EQ(arena.chunkCount(), 3);
+        arena.reset();
+    }
+
+    // Extra chunks went back to the pool and were reused every frame
+    ASSERT_LE(pool.size(), 8);
+}
+
+TEST(Arena, reset_keep_first_chunk)
+{
+    ChunkPool pool;
+    Arena<ChunkPool> arena(pool, 64);
+
+    auto* first = arena.allocate(8, 8);
+    arena.allocate(64, 8);
+    arena.allocate(1024, 8);
+    ASSERT_EQ(arena.chunkCount(), 3);
+
+    // First chunk is rewound, others go back to the pool
+    arena.reset();
+    ASSERT_EQ(arena.chunkCount(), 1);
+    ASSERT_EQ(arena.allocate(8, 8), first);
+    ASSERT_EQ(arena.chunkCount(), 1);
+
+    arena.release();
+    ASSERT_EQ(arena.chunkCount(), 0);
+}
+
+TEST(Arena, oversized_request)
+{
+    ChunkPool pool;
+    Arena<ChunkPool> arena(pool, 64);
+
+    auto* small = static_cast<std::uint8_t*>(arena.allocate(8, 8));
+    auto* big = arena.allocate(1024, 16);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(big) % 16, 0);
+    ASSERT_EQ(arena.chunkCount(), 2);
+
+    // Current chunk keep serving small requests
+    auto* next = static_cast<std::uint8_t*>(arena.allocate(8, 8));
+    ASSERT_EQ(next, small + 8);
+}
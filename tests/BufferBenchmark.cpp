@@ -0,0 +1,54 @@
+// Application Headers
+#include <Recycler/Buffer.hpp>
+#include <Recycler/Circular.hpp>
+
+// C++ Headers
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace recycler;
+
+// Recycle a big buffer where only a few bytes are written each time
+template<std::size_t LENGTH, std::size_t WRITTEN>
+void benchmarkBuffer(int iterations)
+{
+    Circular<Buffer<std::uint8_t>, 4> cache;
+    std::uint8_t data[WRITTEN] = {};
+
+    const auto run = [&](bool declare) {
+        const std::chrono::steady_clock::time_point begin =
+            std::chrono::steady_clock::now();
+        for(int j = 0; j < iterations; ++j)
+        {
+            const auto buffer = cache.make(LENGTH);
+            std::memcpy(buffer->buffer(), data, WRITTEN);
+            if(declare)
+                buffer->markWritten(WRITTEN);
+        }
+        const std::chrono::steady_clock::time_point end =
+            std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            end - begin)
+            .count();
+    };
+
+    const auto us1 = run(false);
+    const auto us2 = run(true);
+
+    std::cout << "Clear whole buffer <" << LENGTH << ", " << WRITTEN
+              << ">   \t" << us1 << " [us]" << std::endl;
+    std::cout << "Clear written only <" << LENGTH << ", " << WRITTEN
+              << ">   \t" << us2 << " [us]" << std::endl;
+    std::cout << "Clear written only is " << (float(us1) / float(us2))
+              << " times faster" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    benchmarkBuffer<65536, 256>(200);
+    benchmarkBuffer<1048576, 256>(20);
+    benchmarkBuffer<1048576, 65536>(20);
+
+    return 0;
+}
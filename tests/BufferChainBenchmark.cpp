@@ -0,0 +1,112 @@
+// Application Headers
+#include <Recycler/BufferChain.hpp>
+
+// C++ Headers
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Posix Headers
+#include <unistd.h>
+
+using namespace recycler;
+
+static constexpr std::size_t HEADER_SIZE = 16;
+
+// Drain the read side of the pipe until it is closed
+static void drain(int fd)
+{
+    std::vector<std::uint8_t> sink(1 << 16);
+    while(::read(fd, sink.data(), sink.size()) > 0) {}
+}
+
+static bool writeAll(int fd, const std::uint8_t* data, std::size_t length)
+{
+    while(length)
+    {
+        const auto written = ::write(fd, data, length);
+        if(written <= 0)
+            return false;
+        data += written;
+        length -= std::size_t(written);
+    }
+    return true;
+}
+
+template<typename F>
+static long long measure(F&& writer)
+{
+    int fds[2];
+    if(::pipe(fds) != 0)
+        return -1;
+
+    std::thread reader(drain, fds[0]);
+    const auto begin = std::chrono::steady_clock::now();
+    writer(fds[1]);
+    ::close(fds[1]);
+    reader.join();
+    const auto end = std::chrono::steady_clock::now();
+    ::close(fds[0]);
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+        .count();
+}
+
+template<std::size_t PAYLOAD>
+void benchmarkBufferChain(int messages)
+{
+    Circular<Buffer<std::uint8_t>, 64> pool;
+    Circular<Buffer<std::uint8_t>, 64> payloads;
+    std::uint8_t header[HEADER_SIZE] = {};
+
+    // Concatenate header and payload into a new buffer before each write
+    const auto us1 = measure([&](int fd) {
+        for(int i = 0; i < messages; ++i)
+        {
+            const auto payload = payloads.make(PAYLOAD, false);
+            const auto message = pool.make(HEADER_SIZE + PAYLOAD, false);
+            std::memcpy(message->buffer(), header, HEADER_SIZE);
+            std::memcpy(message->buffer() + HEADER_SIZE, payload->buffer(),
+                PAYLOAD);
+            writeAll(fd, message->buffer(), message->length());
+        }
+    });
+
+    // Link header and payload in a chain and send them with writev
+    const auto us2 = measure([&](int fd) {
+        BufferChain<Circular<Buffer<std::uint8_t>, 64>> chain(pool, 256);
+        iovec iov[16];
+        for(int i = 0; i < messages; ++i)
+        {
+            chain.append(payloads.make(PAYLOAD, false));
+            chain.prepend(header, HEADER_SIZE);
+            while(!chain.empty())
+            {
+                const auto written =
+                    ::writev(fd, iov, int(chain.iovecs(iov, 16)));
+                if(written <= 0)
+                    return;
+                chain.consume(std::size_t(written));
+            }
+        }
+    });
+
+    const auto bytes = double(messages) * double(HEADER_SIZE + PAYLOAD);
+    std::cout << "copy + write Perf <" << PAYLOAD << ">   \t"
+              << (bytes / double(us1)) << " [MB/s]" << std::endl;
+    std::cout << "BufferChain Perf  <" << PAYLOAD << ">   \t"
+              << (bytes / double(us2)) << " [MB/s]" << std::endl;
+    std::cout << "BufferChain is " << (float(us1) / float(us2))
+              << " times faster" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    benchmarkBufferChain<256>(100000);
+    benchmarkBufferChain<4096>(50000);
+    benchmarkBufferChain<65536>(5000);
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <Recycler/BufferChain.hpp>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if !defined(_WIN32)
+#    include <unistd.h>
+#endif
+
+using namespace recycler;
+
+typedef Circular<Buffer<std::uint8_t>, 8> BufferPool;
+
+static_assert(!std::is_copy_constructible<BufferChain<BufferPool>>::value &&
+                  !std::is_copy_assignable<BufferChain<BufferPool>>::value,
+    "BufferChain copies would share writable segments");
+
+static std::string readAll(BufferChain<BufferPool>& chain)
+{
+    std::string result(chain.length(), '\0');
+    chain.read(&result[0], result.size());
+    return result;
+}
+
+TEST(BufferChain, append_copy)
+{
+    BufferPool pool;
+    BufferChain<BufferPool> chain(pool, 4);
+
+    ASSERT_TRUE(chain.empty());
+    chain.append("hello world", 11);
+    ASSERT_EQ(chain.length(), 11);
+    ASSERT_EQ(chain.segmentCount(), 3);
+
+    ASSERT_EQ(readAll(chain), "hello world");
+    ASSERT_TRUE(chain.empty());
+    ASSERT_EQ(chain.segmentCount(), 0);
+}
+
+TEST(BufferChain, link_without_copy)
+{
+    BufferPool pool;
+    Circular<Buffer<std::uint8_t>> payloads;
+    BufferChain<BufferPool> chain(pool, 16);
+
+    auto payload = payloads.make(5);
+    std::memcpy(payload->buffer(), "world", 5);
+
+    chain.append(payload);
+    chain.prepend("hello ", 6);
+    chain.append("!", 1);
+
+    iovec iov[8];
+    const auto count = chain.iovecs(iov, 8);
+    ASSERT_EQ(count, 3);
+    ASSERT_EQ(iov[1].iov_base, payload->buffer());
+    ASSERT_EQ(iov[1].iov_len, 5);
+    ASSERT_EQ(payload.use_count(), 3);
+
+    ASSERT_EQ(readAll(chain), "hello world!");
+    ASSERT_EQ(payload.use_count(), 2);
+}
+
+TEST(BufferChain, move)
+{
+    BufferPool pool;
+    BufferChain<BufferPool> chain(pool, 4);
+    chain.append("hello world", 11);
+
+    BufferChain<BufferPool> moved(std::move(chain));
+    ASSERT_EQ(moved.length(), 11);
+    ASSERT_EQ(readAll(moved), "hello world");
+}
+
+TEST(BufferChain, prepend_reuse_headroom)
+{
+    BufferPool pool;
+    BufferChain<BufferPool> chain(pool, 16);
+
+    chain.prepend("body", 4);
+    chain.prepend("head:", 5);
+    chain.prepend(">", 1);
+    ASSERT_EQ(chain.segmentCount(), 1);
+    ASSERT_EQ(readAll(chain), ">head:body");
+}
+
+TEST(BufferChain, prepare_commit)
+{
+    BufferPool pool;
+    BufferChain<BufferPool> chain(pool, 4);
+
+    chain.append("ab", 2);
+
+    iovec iov[8];
+    const auto count = chain.prepare(7, iov, 8);
+    ASSERT_EQ(count, 3);
+    ASSERT_EQ(iov[0].iov_len, 2);
+    ASSERT_EQ(iov[1].iov_len, 4);
+    ASSERT_EQ(iov[2].iov_len, 4);
+
+    std::memcpy(iov[0].iov_base, "cd", 2);
+    std::memcpy(iov[1].iov_base, "efgh", 4);
+    std::memcpy(iov[2].iov_base, "i", 1);
+    chain.commit(7);
+
+    ASSERT_EQ(chain.length(), 9);
+    ASSERT_EQ(readAll(chain), "abcdefghi");
+}
+
+TEST(BufferChain, consume_recycle_segments)
+{
+    BufferPool pool;
+    BufferChain<BufferPool> chain(pool, 8);
+
+    for(int i = 0; i < 100; ++i)
+    {
+        chain.append("0123456789abcdef", 16);
+        chain.consume(10);
+        chain.consume(6);
+        ASSERT_TRUE(chain.empty());
+    }
+
+    // Segments went back to the pool and were reused
+    ASSERT_LE(pool.size(), 2);
+}
+
+#if !defined(_WIN32)
+TEST(BufferChain, pipe_roundtrip)
+{
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+
+    BufferPool pool;
+    BufferChain<BufferPool> out(pool, 8);
+    BufferChain<BufferPool> in(pool, 8);
+
+    auto payload = std::make_shared<Buffer<std::uint8_t>>(20);
+    for(std::size_t i = 0; i < payload->length(); ++i)
+        (*payload)[i] = std::uint8_t('a' + i);
+
+    out.append(payload);
+    out.prepend("HDR|", 4);
+
+    iovec iov[8];
+    const auto written = ::writev(fds[1], iov, int(out.iovecs(iov, 8)));
+    ASSERT_EQ(written, 24);
+    out.consume(std::size_t(written));
+    ASSERT_TRUE(out.empty());
+
+    const auto count = in.prepare(24, iov, 8);
+    const auto received = ::readv(fds[0], iov, int(count));
+    ASSERT_EQ(received, 24);
+    in.commit(std::size_t(received));
+
+    std::string result(24, '\0');
+    in.read(&result[0], 24);
+    ASSERT_EQ(result, "HDR|abcdefghijklmnopqrst");
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+#endif
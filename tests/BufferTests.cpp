@@ -1,4 +1,5 @@
 ﻿#include <Recycler/Buffer.hpp>
+#include <Recycler/Circular.hpp>
 #include <gtest/gtest.h>
 #include <string>
 #include <cstring>
@@ -107,3 +108,79 @@ TEST(Buffer, initializer_list3)
     for(std::size_t i = 0; i < buffer.length(); ++i)
         ASSERT_EQ(buffer[i], std::to_string(i + 1));
 }
+
+TEST(Buffer, dirty_range)
+{
+    recycler::Buffer<std::uint8_t> buffer(2048);
+    ASSERT_EQ(buffer.dirtyBegin(), buffer.dirtyEnd());
+
+    buffer[10] = 1;
+    buffer[20] = 2;
+    ASSERT_EQ(buffer.dirtyBegin(), 10);
+    ASSERT_EQ(buffer.dirtyEnd(), 21);
+
+    // Raw access mark the whole length
+    std::memset(buffer, 3, 100);
+    ASSERT_EQ(buffer.dirtyBegin(), 0);
+    ASSERT_EQ(buffer.dirtyEnd(), 2048);
+
+    buffer.reset(2048);
+    ASSERT_EQ(buffer.dirtyBegin(), buffer.dirtyEnd());
+    const auto& cbuffer = buffer;
+    for(std::size_t i = 0; i < cbuffer.length(); ++i) ASSERT_EQ(cbuffer[i], 0);
+}
+
+TEST(Buffer, mark_written)
+{
+    recycler::Buffer<std::uint8_t> buffer(2048);
+
+    std::memset(buffer.buffer(), 7, 2048);
+    buffer.markWritten(16);
+    ASSERT_EQ(buffer.dirtyBegin(), 0);
+    ASSERT_EQ(buffer.dirtyEnd(), 16);
+
+    // Only declared range is cleared
+    buffer.reset(2048);
+    const auto& cbuffer = buffer;
+    ASSERT_EQ(cbuffer[0], 0);
+    ASSERT_EQ(cbuffer[15], 0);
+    ASSERT_EQ(cbuffer[16], 7);
+
+    buffer.markWritten(8, 4096);
+    ASSERT_EQ(buffer.dirtyBegin(), buffer.dirtyEnd());
+}
+
+TEST(Buffer, mark_written_keep_element_access)
+{
+    recycler::Circular<recycler::Buffer<std::uint8_t>> cache;
+    {
+        auto buffer = cache.make(4096);
+        (*buffer)[2000] = 0xAB;
+        std::memset(buffer->buffer(), 1, 16);
+        buffer->markWritten(16);
+        ASSERT_EQ(buffer->dirtyBegin(), 0);
+        ASSERT_EQ(buffer->dirtyEnd(), 2001);
+    }
+
+    const auto buffer = cache.make(4096);
+    const auto& cbuffer = *buffer;
+    for(std::size_t i = 0; i < cbuffer.length(); ++i) ASSERT_EQ(cbuffer[i], 0);
+}
+
+TEST(Buffer, dirty_beyond_length)
+{
+    recycler::Buffer<std::uint8_t> buffer(2048);
+    buffer[1500] = 1;
+    buffer[100] = 1;
+
+    // Shrink, element 1500 isn't visible but still dirty
+    buffer.reset(1024);
+    ASSERT_EQ(buffer.dirtyBegin(), 1024);
+    ASSERT_EQ(buffer.dirtyEnd(), 1501);
+
+    buffer.reset(2048);
+    ASSERT_EQ(buffer.dirtyBegin(), buffer.dirtyEnd());
+    const auto& cbuffer = buffer;
+    ASSERT_EQ(cbuffer[100], 0);
+    ASSERT_EQ(cbuffer[1500], 0);
+}
@@ -3,7 +3,9 @@
 
 #include <gtest/gtest.h>
 
+#include <iterator>
 #include <random>
+#include <vector>
 
 using namespace recycler;
 
@@ -133,3 +135,139 @@ TEST(CircularCacheTests, example)
     ASSERT_EQ(cache.size(), 2);
     ASSERT_EQ(foo2.use_count(), 1);
 }
+
+TEST(CircularCacheTests, resize)
+{
+    Circular<Foo<>, 2> cache;
+
+    ASSERT_FALSE(cache.resize(0));
+    ASSERT_TRUE(cache.resize(4));
+    ASSERT_EQ(cache.maxSize(), 4);
+
+    SharedFoo c[4];
+    for(auto& i: c) i = cache.make();
+    ASSERT_EQ(cache.size(), 4);
+    cache.release();
+    ASSERT_EQ(cache.size(), 0);
+}
+
+template<class Eviction>
+void recycleAnyFreeSlot()
+{
+    Circular<Foo<>, 4, Eviction> cache;
+
+    SharedFoo c[4];
+    for(auto& i: c) i = cache.make();
+    ASSERT_EQ(cache.size(), 4);
+
+    // Neither first nor next slot is free, but the third one is
+    const auto freePtr = c[2].get();
+    c[2] = nullptr;
+    ASSERT_EQ(cache.make().get(), freePtr);
+    ASSERT_EQ(cache.size(), 4);
+}
+
+TEST(CircularCacheTests, clock_recycle_any_free_slot)
+{
+    recycleAnyFreeSlot<ClockEviction>();
+}
+
+TEST(CircularCacheTests, lru_recycle_any_free_slot)
+{
+    recycleAnyFreeSlot<LruEviction>();
+}
+
+TEST(CircularCacheTests, ring_evict_next_slot)
+{
+    Circular<Foo<>, 4> cache;
+
+    SharedFoo c[4];
+    for(auto& i: c) i = cache.make();
+
+    // Ring policy doesn't look further than next slot
+    const auto freePtr = c[2].get();
+    c[2] = nullptr;
+    const auto foo = cache.make();
+    ASSERT_NE(foo.get(), freePtr);
+    ASSERT_EQ(c[0].use_count(), 1);
+}
+
+TEST(CircularCacheTests, clock_keep_reused_slots)
+{
+    Circular<Foo<>, 2, ClockEviction> cache;
+
+    // Slot 0 is reused a lot
+    for(int i = 0; i < 3; ++i) (void)cache.make();
+    const auto hot = cache.make();
+    const auto cold = cache.make();
+    ASSERT_EQ(cache.size(), 2);
+
+    // Slot 1 was never reused, it is evicted first
+    const auto foo = cache.make();
+    ASSERT_EQ(hot.use_count(), 2);
+    ASSERT_EQ(cold.use_count(), 1);
+}
+
+TEST(CircularCacheTests, lru_evict_oldest)
+{
+    Circular<Foo<>, 3, LruEviction> cache;
+
+    SharedFoo c[3];
+    for(auto& i: c) i = cache.make();
+
+    // c[1] is recycled, c[0] is now the oldest handed out
+    const auto ptr = c[1].get();
+    c[1] = nullptr;
+    c[1] = cache.make();
+    ASSERT_EQ(c[1].get(), ptr);
+
+    const auto foo = cache.make();
+    ASSERT_EQ(c[0].use_count(), 1);
+    ASSERT_EQ(c[1].use_count(), 2);
+    ASSERT_EQ(c[2].use_count(), 2);
+}
+
+TEST(CircularCacheTests, makeN)
+{
+    Circular<Foo<>, 8> cache;
+
+    SharedFoo c[4];
+    ASSERT_EQ(cache.makeN(4, c), c + 4);
+    ASSERT_EQ(cache.size(), 4);
+    for(const auto& i: c) ASSERT_EQ(i.use_count(), 2);
+
+    const Foo<>* ptrs[4];
+    for(int i = 0; i < 4; ++i) ptrs[i] = c[i].get();
+
+    // Give back the whole burst, next burst reuse the same objects
+    ASSERT_EQ(cache.releaseN(c, 4), c + 4);
+    for(const auto& i: c) ASSERT_EQ(i, nullptr);
+
+    std::vector<SharedFoo> burst;
+    cache.makeN(6, std::back_inserter(burst));
+    ASSERT_EQ(burst.size(), 6);
+    ASSERT_EQ(cache.size(), 6);
+    for(int i = 0; i < 4; ++i) ASSERT_EQ(burst[i].get(), ptrs[i]);
+    for(const auto& i: burst) ASSERT_EQ(i.use_count(), 2);
+}
+
+TEST(CircularCacheTests, makeN_partial_reuse)
+{
+    Circular<Foo<>, 4> cache;
+
+    SharedFoo c[4];
+    cache.makeN(4, c);
+    c[1] = nullptr;
+    c[3] = nullptr;
+
+    SharedFoo burst[3];
+    cache.makeN(3, burst);
+    ASSERT_EQ(cache.size(), 4);
+    for(const auto& i: burst) ASSERT_NE(i, nullptr);
+    ASSERT_NE(burst[0], burst[1]);
+    ASSERT_NE(burst[1], burst[2]);
+
+    // Third object didn't fit in the cache and replaced a busy one
+    ASSERT_EQ(burst[0].use_count(), 2);
+    ASSERT_EQ(burst[1].use_count(), 2);
+}
@@ -0,0 +1,73 @@
+// Application Headers
+#include <Recycler/Circular.hpp>
+
+// C++ Headers
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace recycler;
+
+// Count every allocation done by the cache
+class Counted
+{
+public:
+    Counted() { ++allocations; }
+    void reset() {}
+
+    std::uint8_t dummyData[1024] = {};
+
+    static std::size_t allocations;
+};
+
+std::size_t Counted::allocations = 0;
+
+// Skewed hold times: most objects are released quickly, a few are kept for a long time
+static const std::size_t ITERATIONS = 200000;
+static const std::size_t HORIZON = 2048;
+
+template<class Eviction>
+void benchmarkEviction(const char* name, double longHoldRatio)
+{
+    Circular<Counted, 64, Eviction> cache;
+
+    // Objects are dropped when their release iteration comes, like a timer wheel
+    std::vector<std::vector<std::shared_ptr<Counted>>> wheel(HORIZON);
+    std::mt19937 rng(42);
+    std::bernoulli_distribution isLong(longHoldRatio);
+    std::uniform_int_distribution<std::size_t> shortHold(1, 8);
+    std::uniform_int_distribution<std::size_t> longHold(256, HORIZON - 1);
+
+    Counted::allocations = 0;
+    const std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < ITERATIONS; ++i)
+    {
+        wheel[i % HORIZON].clear();
+        const auto hold = isLong(rng) ? longHold(rng) : shortHold(rng);
+        wheel[(i + hold) % HORIZON].push_back(cache.make());
+    }
+    const std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+
+    const auto ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+            .count();
+
+    std::cout << name << " <" << longHoldRatio << " long hold>   \t"
+              << Counted::allocations << " allocations for " << ITERATIONS
+              << " make, " << ms << " [ms]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    for(const auto ratio: {0.001, 0.01, 0.05})
+    {
+        benchmarkEviction<RingEviction>("Ring ", ratio);
+        benchmarkEviction<ClockEviction>("Clock", ratio);
+        benchmarkEviction<LruEviction>("Lru  ", ratio);
+    }
+
+    return 0;
+}
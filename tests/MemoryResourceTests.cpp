@@ -0,0 +1,144 @@
+#include <Recycler/MemoryResource.hpp>
+#include <gtest/gtest.h>
+
+#if defined(RECYCLER_HAS_MEMORY_RESOURCE)
+
+#    include <cstdint>
+#    include <map>
+#    include <memory_resource>
+#    include <string>
+#    include <vector>
+
+using namespace recycler;
+
+typedef Circular<Buffer<std::uint8_t>, 8> BufferPool;
+typedef MemoryResource<BufferPool> Resource;
+
+// Count requests that reach upstream
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(
+        void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(MemoryResource, pooled_reuse_blocks)
+{
+    BufferPool pool;
+    Resource resource(pool, Resource::Mode::Pooled, 1024, 256);
+
+    ASSERT_EQ(resource.maxBlockSize(), 256);
+
+    void* a = resource.allocate(24);
+    void* b = resource.allocate(24);
+    ASSERT_NE(a, b);
+    ASSERT_EQ(resource.chunkCount(), 1);
+
+    resource.deallocate(a, 24);
+    ASSERT_EQ(resource.allocate(20), a);
+
+    // Other size classes take their own chunk
+    void* c = resource.allocate(200);
+    ASSERT_EQ(std::uintptr_t(c) % alignof(std::max_align_t), 0);
+    ASSERT_EQ(resource.chunkCount(), 2);
+
+    resource.deallocate(b, 24);
+    resource.deallocate(c, 200);
+}
+
+TEST(MemoryResource, upstream_fallback)
+{
+    BufferPool pool;
+    CountingResource upstream;
+    Resource resource(pool, Resource::Mode::Pooled, 1024, 256, &upstream);
+
+    void* big = resource.allocate(512);
+    ASSERT_EQ(upstream.allocations, 1);
+    void* aligned = resource.allocate(16, 64);
+    ASSERT_EQ(std::uintptr_t(aligned) % 64, 0);
+    ASSERT_EQ(upstream.allocations, 2);
+    ASSERT_EQ(resource.chunkCount(), 0);
+
+    resource.deallocate(big, 512);
+    resource.deallocate(aligned, 16, 64);
+}
+
+TEST(MemoryResource, monotonic)
+{
+    BufferPool pool;
+    Resource resource(pool, Resource::Mode::Monotonic, 256);
+
+    auto* a = static_cast<std::uint8_t*>(resource.allocate(10, 1));
+    auto* b = static_cast<std::uint8_t*>(resource.allocate(8, 8));
+    ASSERT_EQ(std::uintptr_t(b) % 8, 0);
+    ASSERT_GE(b, a + 10);
+    resource.deallocate(a, 10, 1);
+
+    (void)resource.allocate(240);
+    ASSERT_EQ(resource.chunkCount(), 2);
+}
+
+TEST(MemoryResource, recycle_chunks_between_frames)
+{
+    BufferPool pool;
+    Resource resource(pool, Resource::Mode::Monotonic, 4096);
+
+    for(int frame = 0; frame < 10; ++frame)
+    {
+        {
+            std::pmr::vector<int> values(&resource);
+            for(int i = 0; i < 100; ++i) values.push_back(i);
+            std::pmr::string text(
+                "a string long enough to skip small string optimization",
+                &resource);
+            ASSERT_EQ(values[99], 99);
+            ASSERT_EQ(text.size(), 54);
+        }
+        // End of frame
+        resource.release();
+    }
+
+    // Chunks went back to the pool and were reused on every frame
+    ASSERT_LE(pool.size(), 2);
+}
+
+TEST(MemoryResource, containers)
+{
+    BufferPool pool;
+    CountingResource upstream;
+    Resource resource(
+        pool, Resource::Mode::Pooled, 64 * 1024, 4096, &upstream);
+
+    for(int round = 0; round < 10; ++round)
+    {
+        std::pmr::map<int, std::pmr::string> map(&resource);
+        for(int i = 0; i < 200; ++i)
+            map.emplace(i, std::pmr::string(40, char('a' + i % 26)));
+        ASSERT_EQ(map.size(), 200);
+        ASSERT_EQ(map[25], std::pmr::string(40, 'z'));
+    }
+
+    // Freed nodes are reused from one round to the next
+    ASSERT_EQ(upstream.allocations, 0);
+    ASSERT_LE(resource.chunkCount(), 4);
+}
+
+#endif
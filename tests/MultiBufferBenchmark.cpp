@@ -0,0 +1,84 @@
+// Application Headers
+#include <Recycler/Buffer.hpp>
+#include <Recycler/Circular.hpp>
+#include <Recycler/MultiBuffer.hpp>
+
+// C++ Headers
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace recycler;
+
+template<typename F>
+static long long measure(int batches, F&& batch)
+{
+    const std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+    for(int i = 0; i < batches; ++i) batch(i);
+    const std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+        .count();
+}
+
+// Every batch get a position, velocity and id column of a varying length, fill and read them
+template<std::size_t LENGTH>
+void benchmarkMultiBuffer(int batches)
+{
+    float sum = 0.f;
+
+    Circular<Buffer<float>> positions;
+    Circular<Buffer<float>> velocities;
+    Circular<Buffer<std::int32_t>> ids;
+    const auto us1 = measure(batches, [&](int i) {
+        const auto length = LENGTH - std::size_t(i % 16);
+        const auto x = positions.make(length, false);
+        const auto v = velocities.make(length, false);
+        const auto id = ids.make(length, false);
+        float* px = x->buffer();
+        float* pv = v->buffer();
+        std::int32_t* pid = id->buffer();
+        for(std::size_t j = 0; j < length; ++j)
+        {
+            pv[j] = float(j);
+            pid[j] = std::int32_t(j);
+            px[j] += pv[j];
+        }
+        sum += px[length - 1];
+    });
+
+    Circular<MultiBuffer<float, float, std::int32_t>> particles;
+    const auto us2 = measure(batches, [&](int i) {
+        const auto length = LENGTH - std::size_t(i % 16);
+        const auto batch = particles.make(length, false);
+        float* px = batch->template data<0>();
+        float* pv = batch->template data<1>();
+        std::int32_t* pid = batch->template data<2>();
+        for(std::size_t j = 0; j < length; ++j)
+        {
+            pv[j] = float(j);
+            pid[j] = std::int32_t(j);
+            px[j] += pv[j];
+        }
+        sum += px[length - 1];
+    });
+
+    std::cout << "3 x Buffer Perf  <" << LENGTH << ">   \t" << us1 << " [us]"
+              << std::endl;
+    std::cout << "MultiBuffer Perf <" << LENGTH << ">   \t" << us2 << " [us]"
+              << std::endl;
+    std::cout << "MultiBuffer is " << (float(us1) / float(us2))
+              << " times faster (" << (sum > 0.f) << ")" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    benchmarkMultiBuffer<64>(200000);
+    benchmarkMultiBuffer<1024>(20000);
+    benchmarkMultiBuffer<65536>(200);
+
+    return 0;
+}
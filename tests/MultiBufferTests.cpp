@@ -0,0 +1,112 @@
+#include <Recycler/Circular.hpp>
+#include <Recycler/MultiBuffer.hpp>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace recycler;
+
+typedef MultiBuffer<float, std::int32_t, std::uint8_t> Particles;
+
+static bool aligned(const void* p)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % Particles::ALIGNMENT == 0;
+}
+
+TEST(MultiBuffer, columns)
+{
+    Particles particles(100);
+    ASSERT_EQ(particles.length(), 100);
+    ASSERT_EQ(Particles::COLUMNS, 3);
+
+    auto x = particles.column<0>();
+    auto id = particles.column<1>();
+    auto flags = particles.column<2>();
+    ASSERT_EQ(x.length(), 100);
+    ASSERT_EQ(id.length(), 100);
+    ASSERT_EQ(flags.length(), 100);
+
+    ASSERT_TRUE(aligned(x.data()));
+    ASSERT_TRUE(aligned(id.data()));
+    ASSERT_TRUE(aligned(flags.data()));
+
+    for(std::size_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(x[i], 0.f);
+        ASSERT_EQ(id[i], 0);
+        ASSERT_EQ(flags[i], 0);
+        x[i] = float(i);
+        id[i] = std::int32_t(i);
+        flags[i] = 0xff;
+    }
+
+    // Columns don't overlap
+    for(std::size_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(x[i], float(i));
+        ASSERT_EQ(id[i], std::int32_t(i));
+    }
+}
+
+TEST(MultiBuffer, bytes)
+{
+    ASSERT_EQ(Particles::bytes(0), 0);
+    ASSERT_EQ(Particles::bytes(1), 3 * 64);
+    ASSERT_EQ(Particles::bytes(16), 64 + 64 + 64);
+    ASSERT_EQ(Particles::bytes(17), 128 + 128 + 64);
+}
+
+TEST(MultiBuffer, resize_only_when_growing)
+{
+    Particles particles(64);
+    const auto* x = particles.data<0>();
+    const auto* flags = particles.data<2>();
+
+    particles.resize(32);
+    ASSERT_EQ(particles.length(), 32);
+    ASSERT_EQ(particles.maxSize(), 64);
+    ASSERT_EQ(particles.data<0>(), x);
+    ASSERT_EQ(particles.data<2>(), flags);
+
+    particles.resize(128);
+    ASSERT_EQ(particles.maxSize(), 128);
+    ASSERT_TRUE(aligned(particles.data<1>()));
+
+    particles.resize(4);
+    particles.release();
+    ASSERT_EQ(particles.maxSize(), 4);
+
+    particles.clear();
+    ASSERT_TRUE(particles.empty());
+    ASSERT_EQ(particles.data<0>(), nullptr);
+}
+
+TEST(MultiBuffer, reset)
+{
+    Particles particles(8);
+    particles.column<0>()[3] = 1.f;
+    particles.column<1>()[3] = 2;
+
+    particles.reset(8, false);
+    ASSERT_EQ(particles.column<0>()[3], 1.f);
+
+    particles.reset(8);
+    ASSERT_EQ(particles.column<0>()[3], 0.f);
+    ASSERT_EQ(particles.column<1>()[3], 0);
+}
+
+TEST(MultiBuffer, circular)
+{
+    Circular<Particles> cache;
+
+    const float* x = nullptr;
+    {
+        auto particles = cache.make(256, false);
+        x = particles->data<0>();
+    }
+
+    auto particles = cache.make(128);
+    ASSERT_EQ(particles->length(), 128);
+    ASSERT_EQ(particles->data<0>(), x);
+    ASSERT_EQ(cache.size(), 1);
+}
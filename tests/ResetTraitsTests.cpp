@@ -0,0 +1,150 @@
+#include <Recycler/Buffer.hpp>
+#include <Recycler/Circular.hpp>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace recycler;
+
+struct ResetAndClear
+{
+    void reset() { resetCalled = true; }
+    void clear() { clearCalled = true; }
+    bool resetCalled = false;
+    bool clearCalled = false;
+};
+
+template<class T, class = void>
+struct CanResetWithoutArgs : std::false_type
+{
+};
+
+template<class T>
+struct CanResetWithoutArgs<T,
+    decltype(ResetTraits<T>::reset(std::declval<T&>()))> : std::true_type
+{
+};
+
+// Buffer::clear() frees memory, it must be recycled through its own reset(length)
+static_assert(!CanResetWithoutArgs<Buffer<int>>::value,
+    "Buffer must not be reset with clear()");
+static_assert(CanResetWithoutArgs<std::vector<int>>::value,
+    "std::vector must be reset with clear()");
+
+TEST(ResetTraits, buffer_keep_capacity)
+{
+    Circular<Buffer<int>> cache;
+
+    cache.make(1024);
+
+    auto buffer = cache.make(16);
+    ASSERT_EQ(buffer->length(), 16);
+    ASSERT_EQ(buffer->maxSize(), 1024);
+}
+
+TEST(ResetTraits, prefer_reset_over_clear)
+{
+    ResetAndClear object;
+    ResetTraits<ResetAndClear>::reset(object);
+    ASSERT_TRUE(object.resetCalled);
+    ASSERT_FALSE(object.clearCalled);
+}
+
+TEST(ResetTraits, vector_keep_capacity)
+{
+    Circular<std::vector<int>> cache;
+
+    const int* data = nullptr;
+    {
+        auto values = cache.make();
+        values->resize(1000, 42);
+        data = values->data();
+    }
+
+    auto values = cache.make();
+    ASSERT_TRUE(values->empty());
+    ASSERT_GE(values->capacity(), 1000);
+    values->resize(1000);
+    ASSERT_EQ(values->data(), data);
+    ASSERT_EQ(cache.size(), 1);
+}
+
+TEST(ResetTraits, string_keep_capacity)
+{
+    Circular<std::string> cache;
+
+    cache.make()->assign(500, 'x');
+
+    auto text = cache.make();
+    ASSERT_TRUE(text->empty());
+    ASSERT_GE(text->capacity(), 500);
+}
+
+TEST(ResetTraits, unordered_map_keep_buckets)
+{
+    Circular<std::unordered_map<int, int>> cache;
+
+    std::size_t buckets = 0;
+    {
+        auto map = cache.make();
+        for(int i = 0; i < 1000; ++i) (*map)[i] = i;
+        buckets = map->bucket_count();
+    }
+
+    auto map = cache.make();
+    ASSERT_TRUE(map->empty());
+    ASSERT_EQ(map->bucket_count(), buckets);
+}
+
+TEST(ResetTraits, capped_keep_small_capacity)
+{
+    Circular<Capped<std::vector<int>, 256>> cache;
+
+    cache.make()->resize(100);
+
+    auto values = cache.make();
+    ASSERT_TRUE(values->empty());
+    ASSERT_GE(values->capacity(), 100);
+}
+
+TEST(ResetTraits, capped_shrink_outlier)
+{
+    Circular<Capped<std::vector<int>, 256>> cache;
+
+    cache.make()->resize(10000);
+
+    auto values = cache.make();
+    ASSERT_TRUE(values->empty());
+    ASSERT_LE(values->capacity(), 256);
+}
+
+TEST(ResetTraits, capped_unordered_map)
+{
+    Circular<Capped<std::unordered_map<int, int>, 64>> cache;
+
+    {
+        auto map = cache.make();
+        for(int i = 0; i < 1000; ++i) (*map)[i] = i;
+    }
+
+    auto map = cache.make();
+    ASSERT_TRUE(map->empty());
+    ASSERT_LE(map->bucket_count(), 64);
+}
+
+TEST(ResetTraits, capped_node_container)
+{
+    Circular<Capped<std::map<int, int>, 4>> cache;
+
+    {
+        auto map = cache.make();
+        for(int i = 0; i < 100; ++i) (*map)[i] = i;
+    }
+
+    ASSERT_TRUE(cache.make()->empty());
+}
@@ -0,0 +1,162 @@
+#include <Recycler/Circular.hpp>
+#include <Recycler/RingBuffer.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#if defined(__linux__)
+
+#    include <cstring>
+#    include <thread>
+
+using namespace recycler;
+
+TEST(RingBuffer, mirrored)
+{
+    RingBuffer ring(100);
+
+    ASSERT_NE(ring.buffer(), nullptr);
+    ASSERT_GE(ring.length(), 100);
+    ASSERT_EQ(ring.length() % std::size_t(::sysconf(_SC_PAGESIZE)), 0);
+
+    ring[0] = 42;
+    ASSERT_EQ(ring[ring.length()], 42);
+    ring[2 * ring.length() - 1] = 7;
+    ASSERT_EQ(ring[ring.length() - 1], 7);
+}
+
+TEST(RingBuffer, wrap_contiguous)
+{
+    RingBuffer ring(1);
+    const auto length = ring.length();
+
+    // Move cursors close to the end
+    ASSERT_EQ(ring.writeSpan().length(), length);
+    ring.commit(length - 3);
+    ring.consume(length - 3);
+    ASSERT_EQ(ring.readable(), 0);
+
+    // Whole capacity is still writable as one span
+    auto write = ring.writeSpan();
+    ASSERT_EQ(write.length(), length);
+    std::memcpy(write.data(), "abcdefgh", 8);
+    ring.commit(8);
+
+    const auto read = ring.readSpan();
+    ASSERT_EQ(read.length(), 8);
+    ASSERT_EQ(std::memcmp(read.data(), "abcdefgh", 8), 0);
+
+    // Bytes after the end of the first mapping landed at the beginning
+    ASSERT_EQ(ring[0], 'd');
+    ring.consume(8);
+    ASSERT_EQ(ring.readable(), 0);
+    ASSERT_EQ(ring.writable(), length);
+}
+
+TEST(RingBuffer, clamp_commit_consume)
+{
+    RingBuffer ring(4096);
+    const auto length = ring.length();
+
+    ring.commit(length + 10000);
+    ASSERT_EQ(ring.readable(), length);
+    ASSERT_EQ(ring.writable(), 0);
+    ASSERT_TRUE(ring.writeSpan().empty());
+
+    ring.consume(length + 10000);
+    ASSERT_EQ(ring.readable(), 0);
+    ASSERT_EQ(ring.writable(), length);
+}
+
+TEST(RingBuffer, stream_many_laps)
+{
+    RingBuffer ring(4096);
+    const auto length = ring.length();
+
+    // Chunk size doesn't divide length, so cursors land everywhere across laps
+    std::uint8_t next = 0;
+    std::uint8_t expected = 0;
+    for(int i = 0; i < 64; ++i)
+    {
+        auto write = ring.writeSpan();
+        const auto count = std::min<std::size_t>(write.length(), 1000);
+        for(std::size_t j = 0; j < count; ++j) write[j] = next++;
+        ring.commit(count);
+        ASSERT_LE(ring.readable(), length);
+        ASSERT_EQ(ring.readable() + ring.writable(), length);
+
+        const auto read = ring.readSpan();
+        const auto consumed = std::min<std::size_t>(read.length(), 997);
+        for(std::size_t j = 0; j < consumed; ++j)
+            ASSERT_EQ(read[j], expected++);
+        ring.consume(consumed);
+    }
+}
+
+TEST(RingBuffer, reset)
+{
+    RingBuffer ring(4096);
+    ring[0] = 1;
+    ring.commit(10);
+
+    const auto buffer = ring.buffer();
+    ASSERT_TRUE(ring.reset(4096));
+    ASSERT_EQ(ring.buffer(), buffer);
+    ASSERT_EQ(ring[0], 0);
+    ASSERT_EQ(ring.readable(), 0);
+
+    ring.release();
+    ASSERT_EQ(ring.buffer(), nullptr);
+    ASSERT_TRUE(ring.empty());
+    ASSERT_TRUE(ring.writeSpan().empty());
+}
+
+TEST(RingBuffer, circular)
+{
+    Circular<RingBuffer, 2> cache;
+
+    auto ring = cache.make(4096);
+    const auto ptr = ring.get();
+    ring->commit(1);
+    ring = nullptr;
+
+    ring = cache.make(4096);
+    ASSERT_EQ(ring.get(), ptr);
+    ASSERT_EQ(ring->readable(), 0);
+}
+
+TEST(RingBuffer, producer_consumer)
+{
+    RingBuffer ring(4096);
+    const std::size_t total = 1 << 16;
+
+    std::thread producer([&ring, total]() {
+        std::size_t written = 0;
+        while(written < total)
+        {
+            auto span = ring.writeSpan();
+            std::size_t count = 0;
+            for(; count < span.length() && written + count < total; ++count)
+                span[count] = std::uint8_t(written + count);
+            ring.commit(count);
+            written += count;
+        }
+    });
+
+    std::size_t received = 0;
+    bool valid = true;
+    while(received < total)
+    {
+        const auto span = ring.readSpan();
+        for(std::size_t i = 0; i < span.length(); ++i)
+            valid &= span[i] == std::uint8_t(received + i);
+        ring.consume(span.length());
+        received += span.length();
+    }
+    producer.join();
+
+    ASSERT_TRUE(valid);
+    ASSERT_EQ(received, total);
+}
+
+#endif
@@ -0,0 +1,171 @@
+// Application Headers
+#include <Recycler/SharedMemoryPool.hpp>
+
+// C++ Headers
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Posix Headers
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace recycler;
+
+static bool writeAll(int fd, const void* data, std::size_t length)
+{
+    const auto* ptr = static_cast<const std::uint8_t*>(data);
+    while(length)
+    {
+        const auto written = ::write(fd, ptr, length);
+        if(written <= 0)
+            return false;
+        ptr += written;
+        length -= std::size_t(written);
+    }
+    return true;
+}
+
+static bool readAll(int fd, void* data, std::size_t length)
+{
+    auto* ptr = static_cast<std::uint8_t*>(data);
+    while(length)
+    {
+        const auto received = ::read(fd, ptr, length);
+        if(received <= 0)
+            return false;
+        ptr += received;
+        length -= std::size_t(received);
+    }
+    return true;
+}
+
+// Read the whole frame, so the consumer really touch every byte it received
+static std::uint64_t checksum(const std::uint8_t* data, std::size_t length)
+{
+    std::uint64_t sum = 0;
+    for(std::size_t i = 0; i + sizeof(std::uint64_t) <= length;
+        i += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        sum += word;
+    }
+    return sum;
+}
+
+// Run `producer` in a child process and `consumer` in this one, connected with a socket pair
+template<typename P, typename C>
+static long long measure(P&& producer, C&& consumer)
+{
+    int fds[2];
+    if(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        return -1;
+
+    const auto begin = std::chrono::steady_clock::now();
+    const auto pid = ::fork();
+    if(pid == 0)
+    {
+        ::close(fds[0]);
+        producer(fds[1]);
+        ::close(fds[1]);
+        ::_exit(0);
+    }
+
+    ::close(fds[1]);
+    consumer(fds[0]);
+    ::close(fds[0]);
+    ::waitpid(pid, nullptr, 0);
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+        .count();
+}
+
+// Both paths fill every frame in the producer and checksum it in the consumer,
+// so only the handoff differs
+template<std::size_t FRAME>
+void benchmarkSharedMemoryPool(std::size_t frames)
+{
+    const auto name = "/recycler-bench-" + std::to_string(::getpid());
+    SharedMemoryPool pool;
+    if(!pool.create(name, 16, FRAME))
+    {
+        std::cout << "Fail to create shared memory " << name << std::endl;
+        return;
+    }
+
+    // Frames are serialized through the socket
+    std::uint64_t sum1 = 0;
+    const auto us1 = measure(
+        [frames](int fd) {
+            std::vector<std::uint8_t> frame(FRAME);
+            for(std::size_t i = 0; i < frames; ++i)
+            {
+                std::memset(frame.data(), int(i), FRAME);
+                writeAll(fd, frame.data(), frame.size());
+            }
+        },
+        [frames, &sum1](int fd) {
+            std::vector<std::uint8_t> frame(FRAME);
+            for(std::size_t i = 0; i < frames; ++i)
+            {
+                readAll(fd, frame.data(), frame.size());
+                sum1 += checksum(frame.data(), frame.size());
+            }
+        });
+
+    // Frames stay in the shared pool, only handles go through the socket
+    std::uint64_t sum2 = 0;
+    const auto us2 = measure(
+        [&name, frames](int fd) {
+            SharedMemoryPool producer;
+            if(!producer.open(name))
+                return;
+            for(std::size_t i = 0; i < frames; ++i)
+            {
+                auto block = producer.make(FRAME);
+                while(!block)
+                {
+                    std::this_thread::yield();
+                    block = producer.make(FRAME);
+                }
+                std::memset(block.buffer(), int(i), FRAME);
+                const auto handle = block.detach();
+                writeAll(fd, &handle, sizeof(handle));
+            }
+        },
+        [&pool, frames, &sum2](int fd) {
+            for(std::size_t i = 0; i < frames; ++i)
+            {
+                std::uint64_t handle = 0;
+                readAll(fd, &handle, sizeof(handle));
+                const auto block = pool.adopt(handle);
+                sum2 += checksum(block.buffer(), block.length());
+            }
+        });
+
+    if(sum1 != sum2)
+        std::cout << "Checksum mismatch <" << FRAME << ">" << std::endl;
+
+    const auto bytes = double(frames) * double(FRAME);
+    std::cout << "socket Perf           <" << FRAME << ">   \t"
+              << (bytes / double(us1)) << " [MB/s]" << std::endl;
+    std::cout << "SharedMemoryPool Perf <" << FRAME << ">   \t"
+              << (bytes / double(us2)) << " [MB/s]" << std::endl;
+    std::cout << "SharedMemoryPool is " << (float(us1) / float(us2))
+              << " times faster" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    benchmarkSharedMemoryPool<4096>(2000);
+    benchmarkSharedMemoryPool<65536>(500);
+    benchmarkSharedMemoryPool<1048576>(50);
+
+    return 0;
+}
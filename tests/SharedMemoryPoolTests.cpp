@@ -0,0 +1,199 @@
+#include <Recycler/SharedMemoryPool.hpp>
+#include <gtest/gtest.h>
+
+#if !defined(_WIN32)
+
+#    include <cstring>
+#    include <string>
+
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+
+using namespace recycler;
+
+static std::string uniqueName(const char* test)
+{
+    return std::string("/recycler-") + test + "-" + std::to_string(::getpid());
+}
+
+TEST(SharedMemoryPool, make_release)
+{
+    SharedMemoryPool pool;
+    ASSERT_TRUE(pool.create(uniqueName("make"), 2, 100));
+    ASSERT_EQ(pool.slotCount(), 2);
+    ASSERT_GE(pool.blockSize(), 100);
+    ASSERT_EQ(pool.size(), 0);
+
+    auto a = pool.make(10);
+    ASSERT_TRUE(a.valid());
+    ASSERT_EQ(a.length(), 10);
+    ASSERT_EQ(a.useCount(), 1);
+
+    auto b = pool.make();
+    ASSERT_TRUE(b.valid());
+    ASSERT_NE(a.buffer(), b.buffer());
+
+    // Every block is in use
+    ASSERT_FALSE(pool.make().valid());
+    ASSERT_EQ(pool.size(), 2);
+
+    const auto ptr = a.buffer();
+    a.reset();
+    ASSERT_EQ(pool.size(), 1);
+    ASSERT_EQ(pool.make().buffer(), ptr);
+
+    ASSERT_FALSE(b.resize(pool.blockSize() + 1));
+    ASSERT_TRUE(b.resize(pool.blockSize()));
+}
+
+TEST(SharedMemoryPool, handles)
+{
+    SharedMemoryPool pool;
+    ASSERT_TRUE(pool.create(uniqueName("handles"), 4, 64));
+
+    auto block = pool.make(5);
+    const auto copy = block;
+    ASSERT_EQ(block.useCount(), 2);
+
+    auto attached = pool.attach(block.offset());
+    ASSERT_EQ(attached.buffer(), block.buffer());
+    ASSERT_EQ(block.useCount(), 3);
+
+    const auto handle = attached.detach();
+    ASSERT_FALSE(attached.valid());
+    ASSERT_EQ(block.useCount(), 3);
+    auto adopted = pool.adopt(handle);
+    ASSERT_EQ(block.useCount(), 3);
+
+    ASSERT_FALSE(pool.attach(handle + 1).valid());
+    ASSERT_FALSE(pool.adopt(0).valid());
+}
+
+TEST(SharedMemoryPool, attach_freed_block)
+{
+    SharedMemoryPool pool;
+    ASSERT_TRUE(pool.create(uniqueName("freed"), 2, 64));
+
+    auto block = pool.make(5);
+    const auto offset = block.offset();
+    block.reset();
+    ASSERT_EQ(pool.size(), 0);
+
+    // A freed block must not come back into use
+    ASSERT_FALSE(pool.attach(offset).valid());
+    ASSERT_EQ(pool.size(), 0);
+}
+
+TEST(SharedMemoryPool, open_missing)
+{
+    SharedMemoryPool pool;
+    ASSERT_FALSE(pool.open(uniqueName("missing")));
+    ASSERT_FALSE(pool.isOpen());
+
+    SharedMemoryPool owner;
+    ASSERT_TRUE(owner.create(uniqueName("exclusive"), 1, 1));
+    ASSERT_FALSE(pool.create(uniqueName("exclusive"), 1, 1));
+}
+
+TEST(SharedMemoryPool, not_open)
+{
+    SharedMemoryPool pool;
+    ASSERT_EQ(pool.slotCount(), 0);
+    ASSERT_EQ(pool.blockSize(), 0);
+    ASSERT_EQ(pool.size(), 0);
+    ASSERT_FALSE(pool.make().valid());
+    ASSERT_FALSE(pool.adopt(0).valid());
+}
+
+TEST(SharedMemoryPool, open_corrupted)
+{
+    const auto name = uniqueName("corrupted");
+    SharedMemoryPool owner;
+    ASSERT_TRUE(owner.create(name, 4, 64));
+
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    auto* header = static_cast<std::uint64_t*>(::mmap(nullptr,
+        4 * sizeof(std::uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ::close(fd);
+    ASSERT_NE(header, MAP_FAILED);
+
+    // Header is magic, slotCount, blockSize, blocksOffset
+    const auto slotCount = header[1];
+    const auto blockSize = header[2];
+
+    SharedMemoryPool pool;
+    header[2] = 0;
+    ASSERT_FALSE(pool.open(name));
+    header[2] = blockSize;
+
+    header[1] = 0;
+    ASSERT_FALSE(pool.open(name));
+    header[1] = slotCount * 1000;
+    ASSERT_FALSE(pool.open(name));
+    header[1] = slotCount;
+
+    // Blocks would overlap header and slot table
+    const auto blocksOffset = header[3];
+    header[3] = 0;
+    ASSERT_FALSE(pool.open(name));
+    header[3] = blocksOffset;
+
+    ASSERT_TRUE(pool.open(name));
+    ASSERT_EQ(pool.slotCount(), 4);
+
+    ::munmap(header, 4 * sizeof(std::uint64_t));
+}
+
+TEST(SharedMemoryPool, two_processes)
+{
+    const auto name = uniqueName("process");
+    SharedMemoryPool pool;
+    ASSERT_TRUE(pool.create(name, 4, 4096));
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+
+    const auto pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if(pid == 0)
+    {
+        // Child: attach to the pool, fill a block and give it to the parent
+        ::close(fds[0]);
+        SharedMemoryPool child;
+        if(!child.open(name))
+            ::_exit(1);
+        auto block = child.make(6);
+        if(!block)
+            ::_exit(2);
+        std::memcpy(block.buffer(), "frame", 6);
+        const auto handle = block.detach();
+        if(::write(fds[1], &handle, sizeof(handle)) != sizeof(handle))
+            ::_exit(3);
+        ::_exit(0);
+    }
+
+    ::close(fds[1]);
+    std::uint64_t handle = 0;
+    ASSERT_EQ(::read(fds[0], &handle, sizeof(handle)), sizeof(handle));
+    ::close(fds[0]);
+
+    int status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    auto block = pool.adopt(handle);
+    ASSERT_TRUE(block.valid());
+    ASSERT_EQ(block.length(), 6);
+    ASSERT_STREQ(reinterpret_cast<const char*>(block.buffer()), "frame");
+    ASSERT_EQ(block.useCount(), 1);
+
+    // Giving it back makes it available again
+    block.reset();
+    ASSERT_EQ(pool.size(), 0);
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include <Recycler/Circular.hpp>
+#include <Recycler/Tests/Foo.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using namespace recycler;
+
+TEST(Tracer, acquire_release)
+{
+    Circular<Foo<>, 4> cache;
+
+    auto foo = cache.make();
+    ASSERT_EQ(cache.tracer()->acquired(), 1);
+    ASSERT_EQ(cache.tracer()->released(), 0);
+    ASSERT_EQ(cache.tracer()->outstanding().size(), 1);
+
+    const auto copy = foo;
+    foo = nullptr;
+    ASSERT_EQ(cache.tracer()->released(), 0);
+}
+
+TEST(Tracer, recycle_while_traced)
+{
+    Circular<Foo<>, 4> cache;
+
+    auto foo = cache.make();
+    const auto ptr = foo.get();
+    auto bar = cache.make();
+    ASSERT_NE(bar.get(), ptr);
+
+    foo = nullptr;
+    bar = nullptr;
+    ASSERT_EQ(cache.make().get(), ptr);
+    ASSERT_EQ(cache.size(), 2);
+
+    ASSERT_EQ(cache.tracer()->acquired(), 3);
+    ASSERT_EQ(cache.tracer()->released(), 3);
+    ASSERT_TRUE(cache.tracer()->outstanding().empty());
+
+    std::size_t holds = 0;
+    for(const auto count: cache.tracer()->histogram()) holds += count;
+    ASSERT_EQ(holds, 3);
+}
+
+TEST(Tracer, sites)
+{
+    Circular<Foo<>, 4> cache;
+
+    {
+        RECYCLER_TRACE_SITE("short");
+        (void)cache.make();
+    }
+    {
+        RECYCLER_TRACE_SITE("long");
+        const auto foo = cache.make();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    (void)cache.make();
+
+    const auto sites = cache.tracer()->sites();
+    ASSERT_EQ(sites.size(), 3);
+    ASSERT_STREQ(sites[0].site, "long");
+    ASSERT_EQ(sites[0].count, 1);
+    ASSERT_GE(sites[0].max, std::chrono::milliseconds(5));
+}
+
+TEST(Tracer, merge_sites_by_name)
+{
+    // Same name at two addresses, like one literal in two translation units
+    static const char first[] = "decode";
+    static const char second[] = "decode";
+
+    Tracer tracer;
+    int object = 0;
+    tracer.release(tracer.acquire(&object, first));
+    tracer.release(tracer.acquire(&object, second));
+    tracer.release(tracer.acquire(&object, second));
+
+    const auto sites = tracer.sites();
+    ASSERT_EQ(sites.size(), 1);
+    ASSERT_STREQ(sites[0].site, "decode");
+    ASSERT_EQ(sites[0].count, 3);
+}
+
+TEST(Tracer, outstanding_threshold)
+{
+    Circular<Foo<>, 4> cache;
+
+    RECYCLER_TRACE_SITE("leak");
+    const auto leaked = cache.make();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto recent = cache.make();
+
+    // Threshold well below the sleep, `recent` may or may not pass it on a slow machine
+    const auto outstanding =
+        cache.tracer()->outstanding(std::chrono::milliseconds(25));
+    ASSERT_GE(outstanding.size(), 1);
+    ASSERT_EQ(outstanding[0].object, leaked.get());
+    ASSERT_STREQ(outstanding[0].site, "leak");
+    ASSERT_GE(outstanding[0].held, std::chrono::milliseconds(50));
+
+    ASSERT_EQ(cache.tracer()->outstanding().size(), 2);
+    ASSERT_TRUE(cache.tracer()->outstanding(std::chrono::hours(1)).empty());
+}
+
+TEST(Tracer, evict)
+{
+    Circular<Foo<>, 2> cache;
+
+    SharedFoo c[3];
+    for(auto& i: c) i = cache.make();
+
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.tracer()->evicted(), 1);
+}
+
+TEST(Tracer, chrome_trace)
+{
+    Circular<Foo<>, 2> cache;
+
+    {
+        RECYCLER_TRACE_SITE("quote\"site");
+        (void)cache.make();
+    }
+    const auto held = cache.make();
+
+    std::ostringstream os;
+    cache.tracer()->writeChromeTrace(os);
+    const auto json = os.str();
+
+    ASSERT_EQ(json.find("{\"traceEvents\":["), 0);
+    ASSERT_NE(json.find("\"name\":\"quote\\\"site\""), std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"unknown\""), std::string::npos);
+    ASSERT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+}